@@ -24,15 +24,23 @@ public class Cursory : ModuleRules
 			"GameplayTags",
 			"ImageWrapper",
 			"ApplicationCore",
-			"UMG"
+			"UMG",
+			"AssetRegistry"
 		});
 
 		if (Target.Type == TargetType.Editor)
 		{
 			PrivateDependencyModuleNames.AddRange(new string[]
 			{
-				"UnrealEd"
+				"UnrealEd",
+				"DerivedDataCache"
 			});
 		}
+
+		// Needed to free cursor handles, which are SDL cursors on Linux.
+		if (Target.Platform == UnrealTargetPlatform.Linux)
+		{
+			AddEngineThirdPartyPrivateStaticDependencies(Target, "SDL2");
+		}
 	}
 }
@@ -2,8 +2,11 @@
 
 #include "CursoryConformerComponent.h"
 #include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
 #include "CursoryModule.h"
 #include "CursorySystem.h"
+#include "CursoryLatencyTracker.h"
 
 UCursoryConformerComponent::UCursoryConformerComponent()
 {
@@ -14,6 +17,7 @@ void UCursoryConformerComponent::Activate(bool bReset)
 {
 	Super::Activate(bReset);
 
+	UserIndex = UCursorySystem::GetUserIndexForPlayer(Cast<APlayerController>(GetOwner()));
 	ConformInitialCursorState();
 	ListenForCursorChanges();
 }
@@ -25,22 +29,56 @@ void UCursoryConformerComponent::Deactivate()
 	Super::Deactivate();
 }
 
+void UCursoryConformerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Auto-activation happens while the PlayerController spawns, before it is given its LocalPlayer,
+	// so the user resolved then is the primary user's fallback.
+	BindToPlayerUser();
+}
+
+void UCursoryConformerComponent::BindToPlayerUser()
+{
+	if (!IsActive())
+	{
+		return;
+	}
+
+	APlayerController* PlayerOwner = Cast<APlayerController>(GetOwner());
+	if (PlayerOwner && !PlayerOwner->GetLocalPlayer() && PlayerOwner->IsLocalController())
+	{
+		GetWorld()->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &UCursoryConformerComponent::BindToPlayerUser));
+		return;
+	}
+
+	const int32 PlayerUserIndex = UCursorySystem::GetUserIndexForPlayer(PlayerOwner);
+	if (PlayerUserIndex != UserIndex)
+	{
+		StopListeningForCursorChanges();
+		UserIndex = PlayerUserIndex;
+		ListenForCursorChanges();
+		ConformInitialCursorState();
+	}
+}
+
 void UCursoryConformerComponent::ConformInitialCursorState()
 {
 	if (APlayerController* PlayerOwner = Cast<APlayerController>(GetOwner()))
 	{
-		PlayerOwner->CurrentMouseCursor = ICursoryModule::Get().GetCurrentCursorType().GetValue();
+		PlayerOwner->CurrentMouseCursor = ICursoryModule::Get().GetCurrentCursorType(UserIndex).GetValue();
 	}
 }
 
 void UCursoryConformerComponent::ListenForCursorChanges()
 {
-	CursorChangeCallbackHandle = ICursoryModule::Get().CursorTypeChanged.AddUObject(this, &UCursoryConformerComponent::OnCursorChange);
+	CursorChangeCallbackHandle = ICursoryModule::Get().OnCursorTypeChanged(UserIndex).AddUObject(this, &UCursoryConformerComponent::OnCursorChange);
 }
 
 void UCursoryConformerComponent::StopListeningForCursorChanges()
 {
-	ICursoryModule::Get().CursorTypeChanged.Remove(CursorChangeCallbackHandle);
+	ICursoryModule::Get().OnCursorTypeChanged(UserIndex).Remove(CursorChangeCallbackHandle);
+	CursorChangeCallbackHandle.Reset();
 }
 
 void UCursoryConformerComponent::OnCursorChange(EMouseCursor::Type Cursor, EMouseCursor::Type OldCursor)
@@ -48,5 +86,6 @@ void UCursoryConformerComponent::OnCursorChange(EMouseCursor::Type Cursor, EMous
 	if (APlayerController* PlayerOwner = Cast<APlayerController>(GetOwner()))
 	{
 		PlayerOwner->CurrentMouseCursor = Cursor;
+		CURSORY_LATENCY_STAGE(UserIndex, Controller);
 	}
 }
@@ -0,0 +1,405 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryDebug.h"
+
+#if CURSORY_DEBUG
+
+#include "HAL/IConsoleManager.h"
+#include "Debug/DebugDrawService.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Application/SlateUser.h"
+#include "Widgets/SViewport.h"
+#include "Widgets/SWindow.h"
+#include "CursoryModule.h"
+#include "CursorySystem.h"
+#include "CursorySettings.h"
+#include "CursoryScaler.h"
+
+namespace CursoryDebug
+{
+	/** Owners are pruned of removed stack elements past this many. */
+	constexpr int32 MaxOwners = 256;
+
+	/** Slowest loads shown on the overlay. */
+	constexpr int32 MaxOverlayLoads = 5;
+
+	FAutoConsoleCommand DumpCommand(
+		TEXT("Cursory.Dump"),
+		TEXT("Logs every user's cursor stack (with handles and owners), themes, cursor sets and platform handles."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FCursoryDebug::Get().Dump();
+		}));
+
+	FAutoConsoleCommand StatsCommand(
+		TEXT("Cursory.Stats"),
+		TEXT("Logs cursor evaluation/mount counts, resident handles and memory, and per-cursor load timings."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FCursoryDebug::Get().DumpStats();
+		}));
+
+	FAutoConsoleCommand StackBenchmarkCommand(
+		TEXT("Cursory.Benchmark.Stack"),
+		TEXT("Times PushCursor/RemoveCursorByHandle/PopCursor on a spare user's stack, with change dispatch, and reports the stack's heap size. Optional argument: iterations."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			FCursoryDebug::Get().RunStackBenchmark(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100000);
+		}));
+
+	FAutoConsoleCommand OverlayCommand(
+		TEXT("Cursory.Overlay"),
+		TEXT("Toggles an on-screen overlay of the cursor system. Optional argument: 0 to hide, 1 to show."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			FCursoryDebug& Debug = FCursoryDebug::Get();
+			Debug.SetOverlayEnabled(Args.Num() > 0 ? FCString::ToBool(*Args[0]) : !Debug.IsOverlayEnabled());
+		}));
+
+	FString DescribeCursor(EMouseCursor::Type CursorType, const FGameplayTag& Identifier)
+	{
+		return CursorType == EMouseCursor::Custom ? FString::Printf(TEXT("Custom [%s]"), *Identifier.ToString()) : LexToString(CursorType);
+	}
+}
+
+FCursoryDebug& FCursoryDebug::Get()
+{
+	static FCursoryDebug Debug;
+	return Debug;
+}
+
+FString FCursoryDebug::FOwner::ToString() const
+{
+	if (Object.IsExplicitlyNull())
+	{
+		return Label;
+	}
+
+	const FString ObjectName = Function.IsNone() ? GetNameSafe(Object.Get()) : FString::Printf(TEXT("%s.%s"), *GetNameSafe(Object.Get()), *Function.ToString());
+	return FString::Printf(TEXT("%s (%s)"), *ObjectName, Label);
+}
+
+void FCursoryDebug::SetOwner(FCursorStackElementHandle Handle, const FOwner& Owner)
+{
+	if (!Handle.IsValid())
+	{
+		return;
+	}
+
+	// Reserved up front, so that recording never allocates once pruning keeps up.
+	if (Owners.Num() == 0)
+	{
+		Owners.Reserve(CursoryDebug::MaxOwners + 1);
+	}
+
+	if (Owners.Num() >= CursoryDebug::MaxOwners)
+	{
+		const UCursorySystem& System = ICursoryModule::Get();
+		for (auto It = Owners.CreateIterator(); It; ++It)
+		{
+			const FCursorStackElementHandle StackHandle = It.Key();
+			const bool bOnWindowStack = System.WindowContexts.ContainsByPredicate([StackHandle](const UCursorySystem::FWindowCursorContext& Context)
+			{
+				return Context.CursorStack.Contains(StackHandle);
+			});
+
+			if (System.FindUserForHandle(StackHandle) == INDEX_NONE && !bOnWindowStack)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	Owners.Add(Handle, Owner);
+}
+
+void FCursoryDebug::RecordLoad(const FGameplayTag& Identifier, double DecodeSeconds, double CreateSeconds, bool bShared)
+{
+	// Only the latest load of each cursor is kept (e.g. across reloads and themes).
+	FLoadTiming* Existing = Loads.FindByPredicate([&Identifier](const FLoadTiming& Load)
+	{
+		return Load.Identifier == Identifier;
+	});
+
+	FLoadTiming& Load = Existing ? *Existing : Loads.AddDefaulted_GetRef();
+	Load.Identifier = Identifier;
+	Load.DecodeSeconds = DecodeSeconds;
+	Load.CreateSeconds = CreateSeconds;
+	Load.bShared = bShared;
+}
+
+void FCursoryDebug::Dump() const
+{
+	TArray<FString> Lines;
+	GetStackLines(Lines);
+	for (const FString& Line : Lines)
+	{
+		UE_LOG(LogCursory, Display, TEXT("%s"), *Line);
+	}
+
+	const UCursorySystem& System = ICursoryModule::Get();
+	for (const TPair<FName, TMap<FGameplayTag, void*>>& Theme : System.LoadedCustomCursors)
+	{
+		UE_LOG(LogCursory, Display, TEXT("Theme [%s]%s: %d cursors."), *Theme.Key.ToString(), Theme.Key == System.ActiveTheme ? TEXT(" (active)") : TEXT(""), Theme.Value.Num());
+		for (const TPair<FGameplayTag, void*>& Cursor : Theme.Value)
+		{
+			UE_LOG(LogCursory, Display, TEXT("  [%s] -> %p (shared by %d)"), *Cursor.Key.ToString(), Cursor.Value, System.HandleReferences.FindRef(Cursor.Value));
+		}
+	}
+
+	for (const TPair<FName, UCursorySystem::FCursorSet>& Set : System.CursorSets)
+	{
+		UE_LOG(LogCursory, Display, TEXT("Cursor set [%s]: %d specs, %d defined here."), *Set.Key.ToString(), Set.Value.CursorSpecs.Num(), Set.Value.Identifiers.Num());
+	}
+}
+
+void FCursoryDebug::DumpStats() const
+{
+	TArray<FString> Lines;
+	GetStatsLines(Lines);
+	for (const FString& Line : Lines)
+	{
+		UE_LOG(LogCursory, Display, TEXT("%s"), *Line);
+	}
+
+	for (const FLoadTiming& Load : Loads)
+	{
+		UE_LOG(LogCursory, Display, TEXT("  [%s] decode %.2f ms, create %.2f ms%s"),
+			*Load.Identifier.ToString(), Load.DecodeSeconds * 1000.0, Load.CreateSeconds * 1000.0, Load.bShared ? TEXT(" (shared handle)") : TEXT(""));
+	}
+}
+
+void FCursoryDebug::RunStackBenchmark(int32 Iterations)
+{
+	UCursorySystem& System = ICursoryModule::Get();
+
+	// Runs on a user of its own, so that no one's cursor changes. Standard cursors keep the platform out of it.
+	const int32 UserIndex = System.UserStates.Num();
+	if (UserIndex >= UCursorySystem::MaxUsers || UserIndex == System.GetCursorUserIndex())
+	{
+		UE_LOG(LogCursory, Warning, TEXT("Cursor stack benchmark needs a spare user, but none is available."));
+		return;
+	}
+
+	// Real subscribers get the changes queued so far, then are set aside for one that listens to every change.
+	System.DispatchCursorChanges(0.f);
+	TArray<UCursorySystem::FCursorChangeSubscription> Subscriptions = MoveTemp(System.CursorChangeSubscriptions);
+	System.CursorChangeSubscriptions.Reset();
+	const FDelegateHandle Subscription = System.SubscribeToCursorChanges(FCursoryCursorChangeFilter(), FOnCursoryCursorChanges::CreateLambda([](TArrayView<const FCursoryCursorChange> Changes) {}));
+
+	// A typical frame: a few cursors pushed above the base cursor (as by a Blueprint, with its owner recorded),
+	// one removed from the middle, the rest popped, and the net change dispatched.
+	constexpr int32 Depth = 5;
+	constexpr EMouseCursor::Type CursorTypes[Depth] = {EMouseCursor::Hand, EMouseCursor::Crosshairs, EMouseCursor::GrabHand, EMouseCursor::TextEditBeam, EMouseCursor::ResizeLeftRight};
+	auto RunFrame = [this, &System, UserIndex, &CursorTypes]()
+	{
+		FCursorStackElementHandle Handles[Depth];
+		for (int32 Index = 0; Index < Depth; ++Index)
+		{
+			FCursorStackElement Cursor(FCursorStackElementHandle::Generate());
+			Cursor.CursorType = CursorTypes[Index];
+			Handles[Index] = System.PushCursor(Cursor, UserIndex);
+			SetOwner(Handles[Index], FOwner(nullptr, TEXT("Stack benchmark")));
+		}
+
+		System.RemoveCursorByHandle(Handles[Depth / 2]);
+		for (int32 Index = 1; Index < Depth; ++Index)
+		{
+			System.PopCursor(UserIndex);
+		}
+
+		System.DispatchCursorChanges(0.f);
+	};
+
+	// The first frame creates the user, and fills the owner table up to where it is pruned.
+	for (int32 Index = 0; Index < CursoryDebug::MaxOwners / Depth + 1; ++Index)
+	{
+		RunFrame();
+	}
+
+	Iterations = FMath::Max(Iterations, 1);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		RunFrame();
+	}
+	const double Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+	// Allocations are best inspected with Unreal Insights' memory trace; the stack itself reports what it holds.
+	const SIZE_T StackHeapSize = System.UserStates[UserIndex].CursorStack.GetHeapSize();
+
+	System.CursorChangeSubscriptions.Append(MoveTemp(Subscriptions));
+	System.UnsubscribeFromCursorChanges(Subscription);
+	System.UserStates.Pop();
+
+	UE_LOG(LogCursory, Display, TEXT("Cursor stack benchmark (%d frames of %d pushes, a removal and %d pops, with owners and dispatch): %.1f ns/op, stack heap size %llu bytes."),
+		Iterations, Depth, Depth - 1, Seconds * 1e9 / (Iterations * Depth * 2.0), static_cast<uint64>(StackHeapSize));
+}
+
+void FCursoryDebug::SetOverlayEnabled(bool bEnabled)
+{
+	if (bEnabled == IsOverlayEnabled())
+	{
+		return;
+	}
+
+	if (bEnabled)
+	{
+		LastEvaluationCount = EvaluationCount;
+		LastMountCount = MountCount;
+		LastRateTime = FPlatformTime::Seconds();
+		OverlayHandle = UDebugDrawService::Register(TEXT("Game"), FDebugDrawDelegate::CreateRaw(this, &FCursoryDebug::DrawOverlay));
+	}
+
+	else
+	{
+		UDebugDrawService::Unregister(OverlayHandle);
+		OverlayHandle.Reset();
+	}
+}
+
+bool FCursoryDebug::IsOverlayEnabled() const
+{
+	return OverlayHandle.IsValid();
+}
+
+void FCursoryDebug::GetStackLines(TArray<FString>& OutLines) const
+{
+	const UCursorySystem& System = ICursoryModule::Get();
+	const int32 CursorUserIndex = System.GetCursorUserIndex();
+
+	for (int32 UserIndex = 0; UserIndex < System.UserStates.Num(); ++UserIndex)
+	{
+		const FCursoryUserState& UserState = System.UserStates[UserIndex];
+		OutLines.Add(FString::Printf(TEXT("User %d%s: %s"), UserIndex, UserIndex == CursorUserIndex ? TEXT(" (cursor user)") : TEXT(""),
+			*CursoryDebug::DescribeCursor(UserState.CachedCursorType, UserState.CachedCustomCursorIdentifier)));
+
+		// Topmost first, as it dictates the cursor.
+		TArrayView<const FCursoryStackEntry> Entries = UserState.CursorStack.GetEntries();
+		for (int32 Index = Entries.Num() - 1; Index >= 0; --Index)
+		{
+			const FCursoryStackEntry& Element = Entries[Index];
+			const FOwner* Owner = Owners.Find(Element.Handle);
+			OutLines.Add(FString::Printf(TEXT("  %s %s <- %s"), *Element.Handle.ToString(),
+				*CursoryDebug::DescribeCursor(Element.CursorType, Element.CustomCursorIdentifier),
+				Owner ? *Owner->ToString() : Index == 0 ? TEXT("Base") : TEXT("Unknown")));
+		}
+	}
+
+	for (const UCursorySystem::FWindowCursorContext& Context : System.WindowContexts)
+	{
+		const TSharedPtr<SWindow> Window = Context.Window.Pin();
+		OutLines.Add(FString::Printf(TEXT("Window [%s]%s"), Window.IsValid() ? *Window->GetTitle().ToString() : TEXT("closed"),
+			Context.WindowKey == System.ActiveWindow ? TEXT(" (active)") : TEXT("")));
+
+		TArrayView<const FCursoryStackEntry> Entries = Context.CursorStack.GetEntries();
+		for (int32 Index = Entries.Num() - 1; Index >= 0; --Index)
+		{
+			const FCursoryStackEntry& Element = Entries[Index];
+			const FOwner* Owner = Owners.Find(Element.Handle);
+			OutLines.Add(FString::Printf(TEXT("  %s %s <- %s"), *Element.Handle.ToString(),
+				*CursoryDebug::DescribeCursor(Element.CursorType, Element.CustomCursorIdentifier), Owner ? *Owner->ToString() : TEXT("Unknown")));
+		}
+	}
+}
+
+void FCursoryDebug::GetStatsLines(TArray<FString>& OutLines) const
+{
+	const UCursorySystem& System = ICursoryModule::Get();
+
+	OutLines.Add(FString::Printf(TEXT("Evaluations: %llu (%.1f/s), platform mounts: %llu (%.1f/s), viewport auto-focus restores: %llu"),
+		EvaluationCount, EvaluationsPerSecond, MountCount, MountsPerSecond, AutoFocusCount));
+
+	const FCursoryMountStats& MountStats = System.GetMountStats();
+	OutLines.Add(FString::Printf(TEXT("Redundant mounts skipped: %u (same cursor), %u (same handle)"),
+		MountStats.SkippedSameCursor, MountStats.SkippedSameHandle));
+
+	OutLines.Add(FString::Printf(TEXT("Handles: %d unique for %d cursors, theme [%s], scale %.2f, resident images %.1f KB"),
+		System.UniqueHandleCount, System.LoadedCursorCount, *System.ActiveTheme.ToString(), System.GetCursorScale(),
+		System.Scaler.IsValid() ? System.Scaler->GetResidentBytes() / 1024.0 : 0.0));
+
+	double DecodeSeconds = 0.0;
+	double CreateSeconds = 0.0;
+	for (const FLoadTiming& Load : Loads)
+	{
+		DecodeSeconds += Load.DecodeSeconds;
+		CreateSeconds += Load.CreateSeconds;
+	}
+
+	OutLines.Add(FString::Printf(TEXT("Loads: %d, decode %.2f ms, create %.2f ms (total)"), Loads.Num(), DecodeSeconds * 1000.0, CreateSeconds * 1000.0));
+}
+
+void FCursoryDebug::DrawOverlay(UCanvas* Canvas, APlayerController* Player)
+{
+	if (!Canvas || !GEngine)
+	{
+		return;
+	}
+
+	UpdateRates();
+
+	TArray<FString> Lines;
+	GetStackLines(Lines);
+	GetStatsLines(Lines);
+
+	// Slowest loads, since those are the ones worth making deferred (or smaller).
+	TArray<FLoadTiming> SlowestLoads = Loads;
+	SlowestLoads.Sort([](const FLoadTiming& A, const FLoadTiming& B)
+	{
+		return A.DecodeSeconds + A.CreateSeconds > B.DecodeSeconds + B.CreateSeconds;
+	});
+
+	for (int32 Index = 0; Index < FMath::Min(SlowestLoads.Num(), CursoryDebug::MaxOverlayLoads); ++Index)
+	{
+		const FLoadTiming& Load = SlowestLoads[Index];
+		Lines.Add(FString::Printf(TEXT("  [%s] %.2f ms"), *Load.Identifier.ToString(), (Load.DecodeSeconds + Load.CreateSeconds) * 1000.0));
+	}
+
+	// Viewport focus, as audited for auto-focus.
+	const UCursorySystem& System = ICursoryModule::Get();
+	FSlateApplication& SlateApp = FSlateApplication::Get();
+	TSharedPtr<SViewport> GameViewport = SlateApp.GetGameViewport();
+	Lines.Add(FString::Printf(TEXT("Viewport auto-focus: %s"), System.bAutoFocusViewport.Get(GetDefault<UCursorySettings>()->bAutoFocusViewport) ? TEXT("on") : TEXT("off")));
+
+	for (int32 UserIndex = 0; GameViewport.IsValid() && UserIndex < System.UserStates.Num(); ++UserIndex)
+	{
+		TSharedPtr<FSlateUser> SlateUser = SlateApp.GetUser(UserIndex);
+		if (SlateUser.IsValid())
+		{
+			Lines.Add(FString::Printf(TEXT("  User %d: viewport %s, %s"), UserIndex,
+				SlateUser->IsWidgetDirectlyUnderCursor(GameViewport) ? TEXT("hovered") : TEXT("not hovered"),
+				GameViewport->HasUserFocus(UserIndex).IsSet() ? TEXT("focused") : TEXT("not focused")));
+		}
+	}
+
+	UFont* Font = GEngine->GetSmallFont();
+	const float X = 20.f;
+	float Y = 60.f;
+
+	Canvas->SetDrawColor(FColor::White);
+	for (const FString& Line : Lines)
+	{
+		Y += Canvas->DrawText(Font, Line, X, Y);
+	}
+}
+
+void FCursoryDebug::UpdateRates()
+{
+	const double Now = FPlatformTime::Seconds();
+	const double Elapsed = Now - LastRateTime;
+	if (Elapsed < 1.0)
+	{
+		return;
+	}
+
+	EvaluationsPerSecond = (EvaluationCount - LastEvaluationCount) / Elapsed;
+	MountsPerSecond = (MountCount - LastMountCount) / Elapsed;
+
+	LastEvaluationCount = EvaluationCount;
+	LastMountCount = MountCount;
+	LastRateTime = Now;
+}
+
+#endif
@@ -0,0 +1,141 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CursoryTypes.h"
+
+/** Debug commands and the overlay are compiled out of shipping builds. */
+#define CURSORY_DEBUG !UE_BUILD_SHIPPING
+
+#if CURSORY_DEBUG
+
+class UCanvas;
+class APlayerController;
+
+/**
+ * Inspects the live cursor system: stacks, handles, rates and load timings.
+ * Counting is a few integer increments; owners and load timings are kept in small side tables
+ * (owners as a weak object and a name, only described when shown), and nothing is drawn unless the overlay is enabled.
+ *
+ * Console commands:
+ * - Cursory.Dump: logs every user's stack (with handles and owners), themes, sets and platform handles.
+ * - Cursory.Stats: logs evaluation/mount/auto-focus counts, resident handles and memory, and load timings.
+ * - Cursory.Overlay [0|1]: toggles an on-screen overlay of the same, updated live.
+ * - Cursory.Benchmark.Stack [Iterations]: times typical frames of cursor system stack operations, and reports the stack's heap size.
+ */
+class FCursoryDebug
+{
+public:
+
+	static FCursoryDebug& Get();
+
+	/** What pushed a stack element. Cheap to record, as nothing is formatted until it is shown. */
+	struct FOwner
+	{
+		FOwner(const UObject* InObject, const TCHAR* InLabel, FName InFunction = NAME_None)
+			: Object(InObject)
+			, Function(InFunction)
+			, Label(InLabel)
+		{
+		}
+
+		/** Object that pushed the element, if any. */
+		TWeakObjectPtr<const UObject> Object;
+
+		/** Function of the object that pushed the element, if known (e.g. a Blueprint function). */
+		FName Function;
+
+		/** Kind of owner (e.g. "Gamepad cursor"). Must outlive the owner, so string literals only. */
+		const TCHAR* Label;
+
+		FString ToString() const;
+	};
+
+	/** Records what pushed a stack element, to be shown alongside it. */
+	void SetOwner(FCursorStackElementHandle Handle, const FOwner& Owner);
+
+	/** Records the time taken to load a custom cursor. */
+	void RecordLoad(const FGameplayTag& Identifier, double DecodeSeconds, double CreateSeconds, bool bShared);
+
+	void CountEvaluation()
+	{
+		++EvaluationCount;
+	}
+
+	void CountMount()
+	{
+		++MountCount;
+	}
+
+	void CountAutoFocus()
+	{
+		++AutoFocusCount;
+	}
+
+	void Dump() const;
+	void DumpStats() const;
+
+	/**
+	 * Times typical frames of pushes, removals and pops through the cursor system (with owners recorded and changes dispatched),
+	 * on a spare user's stack, and reports the memory the stack holds on the heap.
+	 */
+	void RunStackBenchmark(int32 Iterations);
+
+	void SetOverlayEnabled(bool bEnabled);
+	bool IsOverlayEnabled() const;
+
+private:
+
+	/** Gets the lines shown by Cursory.Dump and the overlay. */
+	void GetStackLines(TArray<FString>& OutLines) const;
+
+	/** Gets the lines shown by Cursory.Stats and the overlay. */
+	void GetStatsLines(TArray<FString>& OutLines) const;
+
+	void DrawOverlay(UCanvas* Canvas, APlayerController* Player);
+
+	/** Updates per-second rates, once a second. */
+	void UpdateRates();
+
+	/** Timings of a custom cursor load. */
+	struct FLoadTiming
+	{
+		FGameplayTag Identifier;
+		double DecodeSeconds{0.0};
+		double CreateSeconds{0.0};
+
+		/** Whether the cursor reused another cursor's handle (so no handle was created). */
+		bool bShared{false};
+	};
+
+	/** Owners of stack elements, by handle. Pruned of removed elements as it grows. */
+	TMap<FCursorStackElementHandle, FOwner> Owners;
+
+	/** Latest load timings of each cursor, in first load order. */
+	TArray<FLoadTiming> Loads;
+
+	uint64 EvaluationCount{0};
+	uint64 MountCount{0};
+	uint64 AutoFocusCount{0};
+
+	/** Counts and time at the last rate update. */
+	uint64 LastEvaluationCount{0};
+	uint64 LastMountCount{0};
+	double LastRateTime{0.0};
+
+	float EvaluationsPerSecond{0.f};
+	float MountsPerSecond{0.f};
+
+	FDelegateHandle OverlayHandle;
+};
+
+#define CURSORY_DEBUG_OWNER(Handle, Owner) FCursoryDebug::Get().SetOwner(Handle, Owner)
+#define CURSORY_DEBUG_COUNT(Counter) FCursoryDebug::Get().Count##Counter()
+
+#else
+
+#define CURSORY_DEBUG_OWNER(Handle, Owner)
+#define CURSORY_DEBUG_COUNT(Counter)
+
+#endif
@@ -0,0 +1,180 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryDecodeCache.h"
+#include "CursoryLoader.h"
+#include "CursoryModule.h"
+#include "CursorySettings.h"
+#include "Misc/SecureHash.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_EDITOR
+#include "DerivedDataCacheInterface.h"
+#endif
+
+namespace CursoryDecodeCache
+{
+	/** Bump to invalidate all cached entries (e.g. when the decoder or entry format changes). */
+	const TCHAR* Version = TEXT("2");
+
+	FString GetCacheDir()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("Cursory") / TEXT("DecodedCursors");
+	}
+
+	FString GetCacheFilePath(const FString& Key)
+	{
+		return GetCacheDir() / Key + TEXT(".bin");
+	}
+
+	bool Deserialize(const TArray<uint8>& Data, FCursoryDecodedCursor& Decoded)
+	{
+		FMemoryReader Reader(Data);
+		int32 Width = 0;
+		int32 Height = 0;
+		TArray64<uint8> Pixels;
+		Reader << Width << Height << Pixels;
+
+		// Reject anything that does not describe a full RGBA image.
+		if (Reader.IsError() || Width <= 0 || Height <= 0 || Pixels.Num() != static_cast<int64>(Width) * Height * 4)
+		{
+			return false;
+		}
+
+		Decoded.Width = Width;
+		Decoded.Height = Height;
+		Decoded.Pixels = MoveTemp(Pixels);
+		return true;
+	}
+}
+
+FString FCursoryDecodeCache::MakeKey(TArrayView<const uint8> SourceData, const FString& Parameters)
+{
+	FSHA1 Sha;
+	Sha.Update(SourceData.GetData(), SourceData.Num());
+	Sha.UpdateWithString(*Parameters, Parameters.Len());
+	Sha.UpdateWithString(CursoryDecodeCache::Version, FCString::Strlen(CursoryDecodeCache::Version));
+	Sha.Final();
+
+	FSHAHash Hash;
+	Sha.GetHash(Hash.Hash);
+	return Hash.ToString();
+}
+
+FString FCursoryDecodeCache::MakeVariantKey(const FString& Key, const FString& Variant)
+{
+	return Key + TEXT("_") + Variant;
+}
+
+bool FCursoryDecodeCache::Get(const FString& Key, FCursoryDecodedCursor& Decoded)
+{
+	TArray<uint8> Data;
+
+#if WITH_EDITOR
+	const FString CacheKey = FDerivedDataCacheInterface::BuildCacheKey(TEXT("CURSORY"), CursoryDecodeCache::Version, *Key);
+	if (!GetDerivedDataCacheRef().GetSynchronous(*CacheKey, Data, TEXT("Cursory")))
+	{
+		return false;
+	}
+#else
+	const FString FilePath = CursoryDecodeCache::GetCacheFilePath(Key);
+	if (!FFileHelper::LoadFileToArray(Data, *FilePath, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	// Pruning goes by timestamp, so keep entries in use looking recent.
+	IFileManager::Get().SetTimeStamp(*FilePath, FDateTime::UtcNow());
+#endif
+
+	return CursoryDecodeCache::Deserialize(Data, Decoded);
+}
+
+void FCursoryDecodeCache::Put(const FString& Key, const FCursoryDecodedCursor& Decoded)
+{
+	if (!Decoded.IsDecoded())
+	{
+		return;
+	}
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	int32 Width = Decoded.Width;
+	int32 Height = Decoded.Height;
+	Writer << Width << Height;
+
+	// Saving does not modify the array, so this avoids copying the pixels.
+	Writer << const_cast<TArray64<uint8>&>(Decoded.Pixels);
+
+#if WITH_EDITOR
+	const FString CacheKey = FDerivedDataCacheInterface::BuildCacheKey(TEXT("CURSORY"), CursoryDecodeCache::Version, *Key);
+	GetDerivedDataCacheRef().Put(*CacheKey, Data, TEXT("Cursory"));
+#else
+	FFileHelper::SaveArrayToFile(Data, *CursoryDecodeCache::GetCacheFilePath(Key));
+#endif
+}
+
+bool FCursoryDecodeCache::IsEnabled()
+{
+#if WITH_EDITOR
+	return GetDefault<UCursorySettings>()->bCacheDecodedCursors;
+#else
+	return GetDefault<UCursorySettings>()->bCacheDecodedCursorsOnDisk;
+#endif
+}
+
+void FCursoryDecodeCache::Prune()
+{
+#if !WITH_EDITOR
+	const UCursorySettings* Settings = GetDefault<UCursorySettings>();
+
+	struct FCacheFile
+	{
+		FString Path;
+		FDateTime ModificationTime;
+		int64 Size;
+	};
+
+	TArray<FCacheFile> Files;
+	IFileManager::Get().IterateDirectoryStat(*CursoryDecodeCache::GetCacheDir(), [&Files](const TCHAR* Path, const FFileStatData& StatData)
+	{
+		if (!StatData.bIsDirectory && FPaths::GetExtension(Path) == TEXT("bin"))
+		{
+			Files.Add({Path, StatData.ModificationTime, StatData.FileSize});
+		}
+
+		return true;
+	});
+
+	// Most recently used first, so that whatever is over the limits is at the back.
+	Files.Sort([](const FCacheFile& A, const FCacheFile& B)
+	{
+		return A.ModificationTime > B.ModificationTime;
+	});
+
+	const FDateTime OldestAllowed = FDateTime::UtcNow() - FTimespan::FromDays(Settings->DecodedCursorCacheMaxAgeDays);
+	const int64 MaxSize = static_cast<int64>(Settings->DecodedCursorCacheMaxSizeMB) * 1024 * 1024;
+
+	int64 TotalSize = 0;
+	int32 DeletedCount = 0;
+	for (const FCacheFile& File : Files)
+	{
+		TotalSize += File.Size;
+
+		const bool bTooOld = Settings->DecodedCursorCacheMaxAgeDays > 0 && File.ModificationTime < OldestAllowed;
+		const bool bOverSize = MaxSize > 0 && TotalSize > MaxSize;
+		if ((bTooOld || bOverSize) && IFileManager::Get().Delete(*File.Path, false, false, true))
+		{
+			++DeletedCount;
+		}
+	}
+
+	if (DeletedCount > 0)
+	{
+		UE_LOG(LogCursory, Log, TEXT("Pruned %d decoded cursor cache files."), DeletedCount);
+	}
+#endif
+}
@@ -0,0 +1,39 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FCursoryDecodedCursor;
+
+/**
+ * Persistent cache of decoded cursor pixels, so that unchanged cursor art
+ * is not decoded (or resampled) again on later launches.
+ * Entries are keyed by a hash of the source file's contents plus the decode parameters.
+ * Uses the Derived Data Cache in the editor, and files under Saved/Cursory/DecodedCursors otherwise,
+ * which are pruned by age and total size on startup.
+ * All functions are safe to call from any thread.
+ */
+struct FCursoryDecodeCache
+{
+	/** Builds a key from the source file contents and decode parameters. */
+	static FString MakeKey(TArrayView<const uint8> SourceData, const FString& Parameters);
+
+	/** Builds a key for a variant (e.g. a resized copy) of a cached entry. */
+	static FString MakeVariantKey(const FString& Key, const FString& Variant);
+
+	/** Fills in the pixels and size of a cursor from the cache. Returns false on a miss. */
+	static bool Get(const FString& Key, FCursoryDecodedCursor& Decoded);
+
+	/** Stores the pixels and size of a decoded cursor. */
+	static void Put(const FString& Key, const FCursoryDecodedCursor& Decoded);
+
+	/** Whether the cache is enabled in the Cursory settings: the Derived Data Cache in the editor, the file cache otherwise. */
+	static bool IsEnabled();
+
+	/**
+	 * Deletes cache files that are too old, then the least recently used while over the size limit.
+	 * Does nothing in the editor, where the Derived Data Cache manages its own size.
+	 */
+	static void Prune();
+};
@@ -9,13 +9,51 @@
 #include "Components/Widget.h"
 #include "Blueprint/UserWidget.h"
 #include "Blueprint/WidgetTree.h"
+#include "CursoryLatencyTracker.h"
+#include "CursoryDebug.h"
+#include "CursoryRegistry.h"
 
-void UCursoryFunctionLibrary::ResetBaseCursor()
+namespace CursoryFunctionLibrary
 {
-	UseBaseStandardCursor(EMouseCursor::Default);
+	/** Creates a widget cursor attribute that follows a user's cursor. */
+	TAttribute<TOptional<EMouseCursor::Type>> MakeCursorAttribute(int32 UserIndex)
+	{
+		TAttribute<TOptional<EMouseCursor::Type>> Callback;
+#if CURSORY_LATENCY_TRACKING
+		Callback.BindLambda([UserIndex]()
+		{
+			CURSORY_LATENCY_STAGE(UserIndex, WidgetQuery);
+			return ICursoryModule::Get().GetCurrentCursorType(UserIndex);
+		});
+#else
+		Callback.BindUObject(&ICursoryModule::Get(), &UCursorySystem::GetCurrentCursorType, UserIndex);
+#endif
+		return Callback;
+	}
+
+#if CURSORY_DEBUG
+	/** Finds the Blueprint calling into the library, for the debug overlay. */
+	FCursoryDebug::FOwner GetCaller()
+	{
+#if DO_BLUEPRINT_GUARD
+		TArrayView<const FFrame* const> ScriptStack = FBlueprintContextTracker::Get().GetCurrentScriptStack();
+		if (ScriptStack.Num() > 0 && ScriptStack.Last()->Object)
+		{
+			const FFrame& Frame = *ScriptStack.Last();
+			return FCursoryDebug::FOwner(Frame.Object, TEXT("Blueprint"), Frame.Node ? Frame.Node->GetFName() : NAME_None);
+		}
+#endif
+		return FCursoryDebug::FOwner(nullptr, TEXT("Blueprint"));
+	}
+#endif
 }
 
-void UCursoryFunctionLibrary::UseBaseStandardCursor(EMouseCursor::Type Cursor)
+void UCursoryFunctionLibrary::ResetBaseCursor(int32 UserIndex /* = 0 */)
+{
+	UseBaseStandardCursor(EMouseCursor::Default, UserIndex);
+}
+
+void UCursoryFunctionLibrary::UseBaseStandardCursor(EMouseCursor::Type Cursor, int32 UserIndex /* = 0 */)
 {
 	if (Cursor == EMouseCursor::Custom)
 	{
@@ -28,10 +66,10 @@ void UCursoryFunctionLibrary::UseBaseStandardCursor(EMouseCursor::Type Cursor)
 		NewBaseCursor.CursorType = Cursor;
 	}
 
-	ICursoryModule::Get().ModifyBaseCursor(NewBaseCursor);
+	ICursoryModule::Get().ModifyBaseCursor(NewBaseCursor, false, false, UserIndex);
 }
 
-void UCursoryFunctionLibrary::UseBaseCustomCursor(FGameplayTag Identifier)
+void UCursoryFunctionLibrary::UseBaseCustomCursor(FGameplayTag Identifier, int32 UserIndex /* = 0 */)
 {
 	FCursorStackElement NewBaseCursor;
 	{
@@ -39,20 +77,22 @@ void UCursoryFunctionLibrary::UseBaseCustomCursor(FGameplayTag Identifier)
 		NewBaseCursor.CustomCursorIdentifier = Identifier;
 	}
 
-	ICursoryModule::Get().ModifyBaseCursor(NewBaseCursor);
+	ICursoryModule::Get().ModifyBaseCursor(NewBaseCursor, false, false, UserIndex);
 }
 
-FCursorStackElementHandle UCursoryFunctionLibrary::PushStandardCursor(EMouseCursor::Type Cursor)
+FCursorStackElementHandle UCursoryFunctionLibrary::PushStandardCursor(EMouseCursor::Type Cursor, int32 UserIndex /* = 0 */)
 {
 	FCursorStackElement NewCursor(FCursorStackElementHandle::Generate());
 	{
 		NewCursor.CursorType = Cursor;
 	}
 
-	return ICursoryModule::Get().PushCursor(NewCursor);
+	const FCursorStackElementHandle Handle = ICursoryModule::Get().PushCursor(NewCursor, UserIndex);
+	CURSORY_DEBUG_OWNER(Handle, CursoryFunctionLibrary::GetCaller());
+	return Handle;
 }
 
-FCursorStackElementHandle UCursoryFunctionLibrary::PushCustomCursor(FGameplayTag Identifier)
+FCursorStackElementHandle UCursoryFunctionLibrary::PushCustomCursor(FGameplayTag Identifier, int32 UserIndex /* = 0 */)
 {
 	FCursorStackElement NewCursor(FCursorStackElementHandle::Generate());
 	{
@@ -60,7 +100,9 @@ FCursorStackElementHandle UCursoryFunctionLibrary::PushCustomCursor(FGameplayTag
 		NewCursor.CustomCursorIdentifier = Identifier;
 	}
 
-	return ICursoryModule::Get().PushCursor(NewCursor);
+	const FCursorStackElementHandle Handle = ICursoryModule::Get().PushCursor(NewCursor, UserIndex);
+	CURSORY_DEBUG_OWNER(Handle, CursoryFunctionLibrary::GetCaller());
+	return Handle;
 }
 
 void UCursoryFunctionLibrary::SetStandardCursorByHandle(FCursorStackElementHandle Handle, EMouseCursor::Type Cursor)
@@ -89,49 +131,98 @@ void UCursoryFunctionLibrary::RemoveCursorByHandle(FCursorStackElementHandle Han
 	ICursoryModule::Get().RemoveCursorByHandle(Handle);
 }
 
-void UCursoryFunctionLibrary::PopCursor()
+void UCursoryFunctionLibrary::PopCursor(int32 UserIndex /* = 0 */)
+{
+	ICursoryModule::Get().PopCursor(UserIndex);
+}
+
+void UCursoryFunctionLibrary::ResetCursorStack(int32 UserIndex /* = 0 */)
+{
+	ICursoryModule::Get().ResetCursorStack(UserIndex);
+}
+
+void UCursoryFunctionLibrary::SetCursorTheme(FName Theme)
+{
+	ICursoryModule::Get().SetTheme(Theme);
+}
+
+void UCursoryFunctionLibrary::PrewarmCursorTheme(FName Theme)
+{
+	ICursoryModule::Get().PrewarmTheme(Theme);
+}
+
+FName UCursoryFunctionLibrary::GetCursorTheme()
+{
+	return ICursoryModule::Get().GetTheme();
+}
+
+void UCursoryFunctionLibrary::SetCursorScale(float Scale /* = 1.0f */)
+{
+	ICursoryModule::Get().SetCursorScale(Scale);
+}
+
+float UCursoryFunctionLibrary::GetCursorScale()
+{
+	return ICursoryModule::Get().GetCursorScale();
+}
+
+ECursorLoadStatus UCursoryFunctionLibrary::GetCursorLoadStatus(FGameplayTag Identifier)
+{
+	return ICursoryModule::Get().GetCursorLoadStatus(Identifier);
+}
+
+void UCursoryFunctionLibrary::PreloadCursor(FGameplayTag Identifier)
 {
-	ICursoryModule::Get().PopCursor();
+	ICursoryModule::Get().RequestCursorLoad(Identifier);
 }
 
-void UCursoryFunctionLibrary::ResetCursorStack()
+bool UCursoryFunctionLibrary::RegisterCursorSet(const UCursoryRegistry* Registry)
 {
-	ICursoryModule::Get().ResetCursorStack();
+	return ICursoryModule::Get().RegisterCursorSet(Registry);
 }
 
-void UCursoryFunctionLibrary::ConformSWidgetToCursory(SWidget* Widget)
+void UCursoryFunctionLibrary::UnregisterCursorSet(const UCursoryRegistry* Registry)
+{
+	if (Registry)
+	{
+		ICursoryModule::Get().UnregisterCursorSet(Registry->GetFName());
+	}
+}
+
+int32 UCursoryFunctionLibrary::GetCursorUserIndex(APlayerController* Player)
+{
+	return UCursorySystem::GetUserIndexForPlayer(Player);
+}
+
+void UCursoryFunctionLibrary::ConformSWidgetToCursory(SWidget* Widget, int32 UserIndex /* = 0 */)
 {
 	if (Widget)
 	{
-		TAttribute<TOptional<EMouseCursor::Type>> Callback;
-		Callback.BindUObject(&ICursoryModule::Get(), &UCursorySystem::GetCurrentCursorType);
-		Widget->SetCursor(Callback);
+		Widget->SetCursor(CursoryFunctionLibrary::MakeCursorAttribute(UserIndex));
 	}
 }
 
-void UCursoryFunctionLibrary::ConformWidgetToCursory(UWidget* Widget)
+void UCursoryFunctionLibrary::ConformWidgetToCursory(UWidget* Widget, int32 UserIndex /* = 0 */)
 {
 	if (Widget)
 	{
 		TSharedPtr<SWidget> UnderlyingWidget = Widget->GetCachedWidget();
 		if (UnderlyingWidget.IsValid())
 		{
-			TAttribute<TOptional<EMouseCursor::Type>> Callback;
-			Callback.BindUObject(&ICursoryModule::Get(), &UCursorySystem::GetCurrentCursorType);
-			UnderlyingWidget->SetCursor(Callback);
+			UnderlyingWidget->SetCursor(CursoryFunctionLibrary::MakeCursorAttribute(UserIndex));
 		}
 	}
 }
 
-void UCursoryFunctionLibrary::ConformWidgetsToCursory(TArray<UWidget*> Widgets)
+void UCursoryFunctionLibrary::ConformWidgetsToCursory(TArray<UWidget*> Widgets, int32 UserIndex /* = 0 */)
 {
 	for (UWidget* Widget : Widgets)
 	{
-		ConformWidgetToCursory(Widget);
+		ConformWidgetToCursory(Widget, UserIndex);
 	}
 }
 
-void UCursoryFunctionLibrary::ConformWidgetToCursoryRecursive(UUserWidget* Widget, bool bDescendantUserWidgets /* = false */)
+void UCursoryFunctionLibrary::ConformWidgetToCursoryRecursive(UUserWidget* Widget, bool bDescendantUserWidgets /* = false */, int32 UserIndex /* = 0 */)
 {
 	if (Widget)
 	{
@@ -139,17 +230,17 @@ void UCursoryFunctionLibrary::ConformWidgetToCursoryRecursive(UUserWidget* Widge
 		
 		if (bDescendantUserWidgets)
 		{
-			WidgetTree->ForEachWidgetAndDescendants([](UWidget* InWidget)
+			WidgetTree->ForEachWidgetAndDescendants([UserIndex](UWidget* InWidget)
 			{
-				ConformWidgetToCursory(InWidget);
+				ConformWidgetToCursory(InWidget, UserIndex);
 			});
 		}
 
 		else
 		{
-			WidgetTree->ForEachWidget([](UWidget* InWidget)
+			WidgetTree->ForEachWidget([UserIndex](UWidget* InWidget)
 			{
-				ConformWidgetToCursory(InWidget);
+				ConformWidgetToCursory(InWidget, UserIndex);
 			});
 		}
 	}
@@ -164,3 +255,32 @@ void UCursoryFunctionLibrary::ResumeAutoFocusViewport()
 {
 	ICursoryModule::Get().SetAutoFocusViewport(false);
 }
+
+void UCursoryFunctionLibrary::SetGamepadCursorEnabled(bool bEnabled)
+{
+	ICursoryModule::Get().SetGamepadCursorEnabled(bEnabled);
+}
+
+void UCursoryFunctionLibrary::AddGamepadCursorTarget(UWidget* Widget)
+{
+	if (Widget)
+	{
+		TSharedPtr<SWidget> UnderlyingWidget = Widget->GetCachedWidget();
+		if (UnderlyingWidget.IsValid())
+		{
+			ICursoryModule::Get().AddGamepadCursorTarget(UnderlyingWidget.ToSharedRef());
+		}
+	}
+}
+
+void UCursoryFunctionLibrary::RemoveGamepadCursorTarget(UWidget* Widget)
+{
+	if (Widget)
+	{
+		TSharedPtr<SWidget> UnderlyingWidget = Widget->GetCachedWidget();
+		if (UnderlyingWidget.IsValid())
+		{
+			ICursoryModule::Get().RemoveGamepadCursorTarget(UnderlyingWidget.ToSharedRef());
+		}
+	}
+}
@@ -0,0 +1,205 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryGamepadCursor.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Application/SlateUser.h"
+#include "Widgets/SWidget.h"
+#include "InputCoreTypes.h"
+#include "CursoryModule.h"
+#include "CursorySettings.h"
+#include "CursorySystem.h"
+#include "CursoryDebug.h"
+
+namespace CursoryGamepadCursor
+{
+	/** Upper bound on a single integration step, so hitches don't fling the cursor. */
+	constexpr float MaxIntegrationStep = 0.1f;
+
+	/** Mouse movement within this distance of the last gamepad-set position is treated as our own. */
+	constexpr float SyntheticMoveTolerance = 1.5f;
+}
+
+void FCursoryGamepadCursor::AddTarget(const TSharedRef<SWidget>& Widget)
+{
+	Targets.AddUnique(Widget);
+}
+
+void FCursoryGamepadCursor::RemoveTarget(const TSharedRef<SWidget>& Widget)
+{
+	Targets.RemoveAll([&Widget](const TWeakPtr<SWidget>& Target)
+	{
+		return !Target.IsValid() || Target.Pin() == Widget;
+	});
+}
+
+void FCursoryGamepadCursor::Reset()
+{
+	if (StackHandle.IsValid())
+	{
+		ICursoryModule::Get().RemoveCursorByHandle(StackHandle);
+		StackHandle = FCursorStackElementHandle();
+	}
+	StickInput = FVector2D::ZeroVector;
+	bDriving = false;
+}
+
+void FCursoryGamepadCursor::Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor)
+{
+	Integrate(SlateApp);
+}
+
+bool FCursoryGamepadCursor::HandleAnalogInputEvent(FSlateApplication& SlateApp, const FAnalogInputEvent& InAnalogInputEvent)
+{
+	if (InAnalogInputEvent.GetUserIndex() != SlateApp.GetCursorUser()->GetUserIndex())
+	{
+		return false;
+	}
+
+	const UCursorySettings* Settings = GetDefault<UCursorySettings>();
+	const FKey XAxis = Settings->bGamepadCursorUsesRightStick ? EKeys::Gamepad_RightX : EKeys::Gamepad_LeftX;
+	const FKey YAxis = Settings->bGamepadCursorUsesRightStick ? EKeys::Gamepad_RightY : EKeys::Gamepad_LeftY;
+	const FKey Key = InAnalogInputEvent.GetKey();
+
+	if (Key != XAxis && Key != YAxis)
+	{
+		return false;
+	}
+
+	// Apply the movement owed for the previous input before taking the new one.
+	Integrate(SlateApp);
+
+	if (Key == XAxis)
+	{
+		StickInput.X = InAnalogInputEvent.GetAnalogValue();
+	}
+
+	else
+	{
+		StickInput.Y = InAnalogInputEvent.GetAnalogValue();
+	}
+
+	return Settings->bConsumeGamepadCursorInput;
+}
+
+bool FCursoryGamepadCursor::HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	// Real mouse movement hands the cursor back to the mouse.
+	if (StackHandle.IsValid() && !bDriving && FVector2D::Distance(MouseEvent.GetScreenSpacePosition(), LastSetPosition) > CursoryGamepadCursor::SyntheticMoveTolerance)
+	{
+		Reset();
+	}
+
+	return false;
+}
+
+void FCursoryGamepadCursor::Integrate(FSlateApplication& SlateApp)
+{
+	const double Now = FPlatformTime::Seconds();
+	const float DeltaTime = FMath::Min(static_cast<float>(Now - LastIntegrationTime), CursoryGamepadCursor::MaxIntegrationStep);
+	LastIntegrationTime = Now;
+
+	const UCursorySettings* Settings = GetDefault<UCursorySettings>();
+	const float Deflection = FMath::Min(StickInput.Size(), 1.0f);
+
+	if (Deflection <= Settings->GamepadCursorDeadZone)
+	{
+		if (bDriving)
+		{
+			EndDriving(SlateApp);
+		}
+		return;
+	}
+
+	if (!bDriving)
+	{
+		BeginDriving(SlateApp);
+		return;
+	}
+
+	HeldTime += DeltaTime;
+
+	// Rescale deflection outside the dead zone to 0..1, then apply response curve and acceleration ramp.
+	const float Normalized = (Deflection - Settings->GamepadCursorDeadZone) / (1.0f - Settings->GamepadCursorDeadZone);
+	const float Response = FMath::Pow(Normalized, Settings->GamepadCursorResponseExponent);
+	const float Ramp = Settings->GamepadCursorAccelerationTime > 0.0f ? FMath::Min(HeldTime / Settings->GamepadCursorAccelerationTime, 1.0f) : 1.0f;
+
+	// Stick Y is up, screen Y is down.
+	const FVector2D Direction = FVector2D(StickInput.X, -StickInput.Y).GetSafeNormal();
+	CursorPosition += Direction * Response * Ramp * Settings->GamepadCursorSpeed * DeltaTime;
+
+	FVector2D TargetCenter;
+	if (FindNearestTarget(CursorPosition, Settings->GamepadCursorMagnetismRadius, TargetCenter))
+	{
+		const float Pull = FMath::Clamp(Settings->GamepadCursorMagnetismStrength * DeltaTime, 0.0f, 1.0f);
+		CursorPosition += (TargetCenter - CursorPosition) * Pull;
+	}
+
+	LastSetPosition = CursorPosition;
+	SlateApp.SetCursorPos(CursorPosition);
+}
+
+void FCursoryGamepadCursor::BeginDriving(FSlateApplication& SlateApp)
+{
+	bDriving = true;
+	HeldTime = 0.0f;
+	CursorPosition = SlateApp.GetCursorPos();
+
+	const FGameplayTag& Identifier = GetDefault<UCursorySettings>()->GamepadCursorIdentifier;
+	if (Identifier.IsValid() && !StackHandle.IsValid())
+	{
+		FCursorStackElement GamepadCursor(FCursorStackElementHandle::Generate());
+		{
+			GamepadCursor.CursorType = EMouseCursor::Custom;
+			GamepadCursor.CustomCursorIdentifier = Identifier;
+		}
+		StackHandle = ICursoryModule::Get().PushCursor(GamepadCursor, SlateApp.GetCursorUser()->GetUserIndex());
+		CURSORY_DEBUG_OWNER(StackHandle, FCursoryDebug::FOwner(nullptr, TEXT("Gamepad cursor")));
+	}
+}
+
+void FCursoryGamepadCursor::EndDriving(FSlateApplication& SlateApp)
+{
+	bDriving = false;
+	HeldTime = 0.0f;
+
+	FVector2D TargetCenter;
+	if (FindNearestTarget(CursorPosition, GetDefault<UCursorySettings>()->GamepadCursorSnapRadius, TargetCenter))
+	{
+		CursorPosition = TargetCenter;
+		LastSetPosition = CursorPosition;
+		SlateApp.SetCursorPos(CursorPosition);
+	}
+}
+
+bool FCursoryGamepadCursor::FindNearestTarget(const FVector2D& Position, float Radius, FVector2D& OutCenter)
+{
+	float NearestDistanceSquared = FMath::Square(Radius);
+	bool bFound = false;
+
+	for (int32 TargetIndex = Targets.Num() - 1; TargetIndex >= 0; --TargetIndex)
+	{
+		TSharedPtr<SWidget> Target = Targets[TargetIndex].Pin();
+		if (!Target.IsValid())
+		{
+			Targets.RemoveAtSwap(TargetIndex);
+			continue;
+		}
+
+		if (!Target->GetVisibility().IsVisible())
+		{
+			continue;
+		}
+
+		// Absolute Slate coordinates are desktop space, same as the cursor.
+		const FVector2D Center = Target->GetTickSpaceGeometry().GetAbsolutePositionAtCoordinates(FVector2D(0.5f, 0.5f));
+		const float DistanceSquared = FVector2D::DistSquared(Position, Center);
+		if (DistanceSquared <= NearestDistanceSquared)
+		{
+			NearestDistanceSquared = DistanceSquared;
+			OutCenter = Center;
+			bFound = true;
+		}
+	}
+
+	return bFound;
+}
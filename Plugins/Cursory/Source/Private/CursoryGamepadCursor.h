@@ -0,0 +1,78 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/Application/IInputProcessor.h"
+#include "CursoryTypes.h"
+
+class SWidget;
+
+/**
+ * Drives the hardware cursor from gamepad stick input.
+ * Movement is integrated whenever stick input arrives (and on Slate tick,
+ * to cover frames without events), so no game tick or Blueprint work is required.
+ * Registered targets attract the cursor when nearby, and the cursor snaps
+ * onto them when the stick is released.
+ */
+class FCursoryGamepadCursor : public IInputProcessor
+{
+public:
+
+	/** Adds a widget that attracts the cursor. */
+	void AddTarget(const TSharedRef<SWidget>& Widget);
+
+	/** Removes a widget that attracts the cursor. */
+	void RemoveTarget(const TSharedRef<SWidget>& Widget);
+
+	/** Removes the gamepad cursor from the stack, if pushed. */
+	void Reset();
+
+	//~ Begin IInputProcessor Interface
+	void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override;
+	bool HandleAnalogInputEvent(FSlateApplication& SlateApp, const FAnalogInputEvent& InAnalogInputEvent) override;
+	bool HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	const TCHAR* GetDebugName() const override { return TEXT("CursoryGamepadCursor"); }
+	//~ End IInputProcessor Interface
+
+private:
+
+	/** Moves the cursor according to the stick input held since the last integration. */
+	void Integrate(FSlateApplication& SlateApp);
+
+	/** Called when the gamepad starts driving the cursor. */
+	void BeginDriving(FSlateApplication& SlateApp);
+
+	/** Called when the stick is released. */
+	void EndDriving(FSlateApplication& SlateApp);
+
+	/**
+	 * Finds the center of the nearest visible target within the specified radius.
+	 * Returns false if there is none.
+	 */
+	bool FindNearestTarget(const FVector2D& Position, float Radius, FVector2D& OutCenter);
+
+	/** Current stick deflection (X right, Y up). */
+	FVector2D StickInput{FVector2D::ZeroVector};
+
+	/** Unrounded cursor position, to preserve sub-pixel movement between integrations. */
+	FVector2D CursorPosition{FVector2D::ZeroVector};
+
+	/** Last position the cursor was moved to by the gamepad. */
+	FVector2D LastSetPosition{FVector2D::ZeroVector};
+
+	/** Time of the last integration. */
+	double LastIntegrationTime{0.0};
+
+	/** How long the stick has been held outside the dead zone. */
+	float HeldTime{0.0f};
+
+	/** Whether the gamepad is currently driving the cursor. */
+	bool bDriving{false};
+
+	/** Handle for the gamepad cursor on the stack, if pushed. */
+	FCursorStackElementHandle StackHandle;
+
+	/** Widgets that attract the cursor. */
+	TArray<TWeakPtr<SWidget>> Targets;
+};
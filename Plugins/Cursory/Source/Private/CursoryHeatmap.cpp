@@ -0,0 +1,346 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryHeatmap.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Widgets/SViewport.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Async/Async.h"
+#include "Misc/CoreDelegates.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "CursoryModule.h"
+#include "CursorySystem.h"
+
+namespace CursoryHeatmap
+{
+	constexpr uint32 Magic = 0x50414d48; // "HMAP"
+	constexpr int32 Version = 1;
+
+	/** Upper bound on a grid dimension, to reject corrupt files. */
+	constexpr int32 MaxResolution = 1024;
+
+	/** Final save of the last stopped capture, which exit waits for. */
+	TFuture<void> StopSave;
+	FDelegateHandle StopSaveExitHandle;
+
+	void WaitForStopSave()
+	{
+		if (StopSave.IsValid())
+		{
+			StopSave.Wait();
+		}
+	}
+
+	FAutoConsoleCommand StartCommand(
+		TEXT("Cursory.Heatmap.Start"),
+		TEXT("Starts capturing a cursor heatmap."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			ICursoryModule::Get().SetHeatmapCaptureEnabled(true);
+		}));
+
+	FAutoConsoleCommand StopCommand(
+		TEXT("Cursory.Heatmap.Stop"),
+		TEXT("Stops capturing the cursor heatmap, and saves it."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			ICursoryModule::Get().SetHeatmapCaptureEnabled(false);
+		}));
+
+	FAutoConsoleCommand FlushCommand(
+		TEXT("Cursory.Heatmap.Flush"),
+		TEXT("Saves the cursor heatmap captured so far."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			ICursoryModule::Get().FlushHeatmap();
+		}));
+}
+
+bool FCursoryHeatmapData::Merge(const FCursoryHeatmapData& Other)
+{
+	if (Layers.Num() == 0 && Duration == 0.0)
+	{
+		Resolution = Other.Resolution;
+	}
+
+	if (Other.Resolution != Resolution)
+	{
+		return false;
+	}
+
+	Duration += Other.Duration;
+	for (const FLayer& OtherLayer : Other.Layers)
+	{
+		FLayer* Layer = Layers.FindByPredicate([&OtherLayer](const FLayer& Candidate)
+		{
+			return Candidate.CursorName == OtherLayer.CursorName;
+		});
+
+		if (!Layer)
+		{
+			Layers.Add(OtherLayer);
+			continue;
+		}
+
+		for (int32 Cell = 0; Cell < Layer->Moves.Num(); ++Cell)
+		{
+			Layer->Moves[Cell] += OtherLayer.Moves[Cell];
+			Layer->Presses[Cell] += OtherLayer.Presses[Cell];
+		}
+	}
+
+	return true;
+}
+
+bool FCursoryHeatmapData::SaveToFile(const FString& Path) const
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+
+	uint32 Magic = CursoryHeatmap::Magic;
+	int32 Version = CursoryHeatmap::Version;
+	FIntPoint SavedResolution = Resolution;
+	double SavedDuration = Duration;
+	Writer << Magic << Version << SavedResolution << SavedDuration;
+
+	// Saving does not modify the layers, so this avoids copying them.
+	Writer << const_cast<TArray<FLayer>&>(Layers);
+
+	return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FCursoryHeatmapData::LoadFromFile(const FString& Path)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Reader << Magic << Version;
+	if (Reader.IsError() || Magic != CursoryHeatmap::Magic || Version != CursoryHeatmap::Version)
+	{
+		return false;
+	}
+
+	Reader << Resolution << Duration;
+	if (Reader.IsError() || Resolution.X <= 0 || Resolution.Y <= 0 || Resolution.X > CursoryHeatmap::MaxResolution || Resolution.Y > CursoryHeatmap::MaxResolution)
+	{
+		return false;
+	}
+
+	Reader << Layers;
+
+	// Reject anything that does not cover the full grid.
+	const int32 NumCells = Resolution.X * Resolution.Y;
+	return !Reader.IsError() && !Layers.ContainsByPredicate([NumCells](const FLayer& Layer)
+	{
+		return Layer.Moves.Num() != NumCells || Layer.Presses.Num() != NumCells;
+	});
+}
+
+bool FCursoryHeatmapData::ExportCsv(const FString& Path) const
+{
+	FString Csv = TEXT("Cursor,X,Y,Moves,Presses");
+	Csv += LINE_TERMINATOR;
+
+	for (const FLayer& Layer : Layers)
+	{
+		for (int32 Cell = 0; Cell < Layer.Moves.Num(); ++Cell)
+		{
+			if (Layer.Moves[Cell] > 0 || Layer.Presses[Cell] > 0)
+			{
+				Csv += FString::Printf(TEXT("%s,%d,%d,%u,%u"), *Layer.CursorName, Cell % Resolution.X, Cell / Resolution.X, Layer.Moves[Cell], Layer.Presses[Cell]);
+				Csv += LINE_TERMINATOR;
+			}
+		}
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *Path);
+}
+
+FCursoryHeatmap::FCursoryHeatmap(FCursoryMouseSampleReader&& InReader, FIntPoint InResolution, float FlushInterval)
+	: Reader(MoveTemp(InReader))
+	, Resolution(InResolution.ComponentMax(FIntPoint(1, 1)).ComponentMin(FIntPoint(CursoryHeatmap::MaxResolution, CursoryHeatmap::MaxResolution)))
+	, Path(FPaths::ProjectSavedDir() / TEXT("Cursory") / TEXT("Heatmaps") / FString::Printf(TEXT("Heatmap-%s.cursorheat"), *FDateTime::Now().ToString()))
+{
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FCursoryHeatmap::Tick));
+	FlushHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FCursoryHeatmap::FlushPeriodically), FMath::Max(FlushInterval, 1.0f));
+	PreExitHandle = FCoreDelegates::OnPreExit.AddRaw(this, &FCursoryHeatmap::Save);
+
+	UE_LOG(LogCursory, Log, TEXT("Capturing cursor heatmap to [%s]."), *Path);
+}
+
+FCursoryHeatmap::~FCursoryHeatmap()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(FlushHandle);
+	FCoreDelegates::OnPreExit.Remove(PreExitHandle);
+
+	// On exit, the save has to be done before the process is.
+	if (IsEngineExitRequested())
+	{
+		Save();
+		return;
+	}
+
+	// Otherwise stopping should not hitch, so the final save follows any save in flight on the thread pool.
+	CursoryHeatmap::StopSave = Async(EAsyncExecution::ThreadPool, [PreviousSave = MoveTemp(PendingSave), PreviousStopSave = MoveTemp(CursoryHeatmap::StopSave), Data = MakeData(), SavePath = Path]()
+	{
+		if (PreviousStopSave.IsValid())
+		{
+			PreviousStopSave.Wait();
+		}
+
+		if (PreviousSave.IsValid())
+		{
+			PreviousSave.Wait();
+		}
+
+		if (!Data.SaveToFile(SavePath))
+		{
+			UE_LOG(LogCursory, Warning, TEXT("Failed to save cursor heatmap to [%s]."), *SavePath);
+		}
+	});
+
+	if (!CursoryHeatmap::StopSaveExitHandle.IsValid())
+	{
+		CursoryHeatmap::StopSaveExitHandle = FCoreDelegates::OnPreExit.AddStatic(&CursoryHeatmap::WaitForStopSave);
+	}
+}
+
+void FCursoryHeatmap::Save()
+{
+	if (PendingSave.IsValid())
+	{
+		PendingSave.Wait();
+	}
+
+	if (!MakeData().SaveToFile(Path))
+	{
+		UE_LOG(LogCursory, Warning, TEXT("Failed to save cursor heatmap to [%s]."), *Path);
+	}
+}
+
+void FCursoryHeatmap::Flush()
+{
+	if (PendingSave.IsValid() && !PendingSave.IsReady())
+	{
+		return;
+	}
+
+	PendingSave = Async(EAsyncExecution::ThreadPool, [Data = MakeData(), SavePath = Path]()
+	{
+		if (!Data.SaveToFile(SavePath))
+		{
+			UE_LOG(LogCursory, Warning, TEXT("Failed to save cursor heatmap to [%s]."), *SavePath);
+		}
+	});
+}
+
+bool FCursoryHeatmap::FlushPeriodically(float DeltaTime)
+{
+	Flush();
+	return true;
+}
+
+bool FCursoryHeatmap::Tick(float DeltaTime)
+{
+	Duration += DeltaTime;
+
+	const FCursoryMouseSampleSpan Samples = Reader.Read();
+	if (Samples.Num() == 0 || !FSlateApplication::IsInitialized())
+	{
+		return true;
+	}
+
+	TSharedPtr<SViewport> GameViewport = FSlateApplication::Get().GetGameViewport();
+	if (!GameViewport.IsValid())
+	{
+		return true;
+	}
+
+	const FGeometry& Geometry = GameViewport->GetCachedGeometry();
+	const FVector2D Size = Geometry.GetLocalSize();
+	if (Size.X <= 0.0 || Size.Y <= 0.0)
+	{
+		return true;
+	}
+
+	// The cursor cannot change between samples of one frame, so it is looked up once per user.
+	UCursorySystem& System = ICursoryModule::Get();
+	int32 CachedUserIndex = INDEX_NONE;
+	int32 GridIndex = INDEX_NONE;
+
+	Samples.ForEach([&](const FCursoryMouseSample& Sample)
+	{
+		if (Sample.UserIndex != CachedUserIndex)
+		{
+			CachedUserIndex = Sample.UserIndex;
+			const EMouseCursor::Type CursorType = System.GetCurrentCursorType(Sample.UserIndex).Get(EMouseCursor::Default);
+			GridIndex = CursorType != EMouseCursor::None ? FindOrAddGrid(CursorType, System.GetCurrentCustomCursorIdentifier(Sample.UserIndex)) : INDEX_NONE;
+		}
+
+		if (GridIndex == INDEX_NONE)
+		{
+			return;
+		}
+
+		const FVector2D Local = Geometry.AbsoluteToLocal(Sample.ScreenPosition);
+		if (Local.X < 0.0 || Local.Y < 0.0 || Local.X >= Size.X || Local.Y >= Size.Y)
+		{
+			return;
+		}
+
+		const int32 X = FMath::Min(static_cast<int32>(Local.X / Size.X * Resolution.X), Resolution.X - 1);
+		const int32 Y = FMath::Min(static_cast<int32>(Local.Y / Size.Y * Resolution.Y), Resolution.Y - 1);
+		FGrid& Grid = Grids[GridIndex];
+		++(Sample.bPressed ? Grid.Presses : Grid.Moves)[Y * Resolution.X + X];
+	});
+
+	return true;
+}
+
+FCursoryHeatmapData FCursoryHeatmap::MakeData() const
+{
+	FCursoryHeatmapData Data;
+	Data.Resolution = Resolution;
+	Data.Duration = Duration;
+
+	for (const FGrid& Grid : Grids)
+	{
+		FCursoryHeatmapData::FLayer& Layer = Data.Layers.AddDefaulted_GetRef();
+		Layer.CursorName = Grid.CursorType == EMouseCursor::Custom && Grid.CustomCursorIdentifier.IsValid() ? Grid.CustomCursorIdentifier.ToString() : LexToString(Grid.CursorType);
+		Layer.Moves = Grid.Moves;
+		Layer.Presses = Grid.Presses;
+	}
+
+	return Data;
+}
+
+int32 FCursoryHeatmap::FindOrAddGrid(EMouseCursor::Type CursorType, const FGameplayTag& CustomCursorIdentifier)
+{
+	// Stacks may keep a custom identifier under a standard cursor type, which does not make it a different cursor.
+	const FGameplayTag& Identifier = CursorType == EMouseCursor::Custom ? CustomCursorIdentifier : FGameplayTag::EmptyTag;
+	const int32 Index = Grids.IndexOfByPredicate([CursorType, &Identifier](const FGrid& Grid)
+	{
+		return Grid.CursorType == CursorType && Grid.CustomCursorIdentifier == Identifier;
+	});
+
+	if (Index != INDEX_NONE)
+	{
+		return Index;
+	}
+
+	FGrid& Grid = Grids.AddDefaulted_GetRef();
+	Grid.CursorType = CursorType;
+	Grid.CustomCursorIdentifier = Identifier;
+	Grid.Moves.SetNumZeroed(Resolution.X * Resolution.Y);
+	Grid.Presses.SetNumZeroed(Resolution.X * Resolution.Y);
+	return Grids.Num() - 1;
+}
@@ -0,0 +1,122 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "GenericPlatform/ICursor.h"
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
+#include "CursoryMouseSamples.h"
+
+/**
+ * Heatmap counts, as saved to disk.
+ * Cells are laid out row-major over a grid spanning the game viewport.
+ */
+struct FCursoryHeatmapData
+{
+	/** Counts recorded while one cursor was showing. */
+	struct FLayer
+	{
+		/** Custom cursor identifier, or standard cursor type name. */
+		FString CursorName;
+
+		TArray<uint32> Moves;
+		TArray<uint32> Presses;
+
+		friend FArchive& operator<<(FArchive& Ar, FLayer& Layer)
+		{
+			return Ar << Layer.CursorName << Layer.Moves << Layer.Presses;
+		}
+	};
+
+	FIntPoint Resolution{0, 0};
+
+	/** Time captured, in seconds. */
+	double Duration{0.0};
+
+	TArray<FLayer> Layers;
+
+	/** Adds the counts of another heatmap, by cursor. Fails if the resolutions differ. */
+	bool Merge(const FCursoryHeatmapData& Other);
+
+	bool SaveToFile(const FString& Path) const;
+	bool LoadFromFile(const FString& Path);
+
+	/** Writes one row per non-empty cell: Cursor, X, Y, Moves, Presses. */
+	bool ExportCsv(const FString& Path) const;
+};
+
+/**
+ * Records where the cursor moves and clicks, and which cursor was showing,
+ * into a downsampled grid over the game viewport.
+ *
+ * Samples come from the shared mouse sample buffer, which is read once per frame,
+ * so no input listener is added. Memory is only allocated when a cursor is first seen.
+ * Moves with the cursor hidden (e.g. mouse look) are not recorded.
+ * Counts are saved periodically on the thread pool, to Saved/Cursory/Heatmaps.
+ * Merge sessions with the CursoryHeatmapMerge commandlet.
+ *
+ * Console commands:
+ * - Cursory.Heatmap.Start: starts capturing.
+ * - Cursory.Heatmap.Stop: stops capturing, and saves.
+ * - Cursory.Heatmap.Flush: saves the counts so far.
+ */
+class FCursoryHeatmap
+{
+public:
+
+	FCursoryHeatmap(FCursoryMouseSampleReader&& InReader, FIntPoint InResolution, float FlushInterval);
+
+	/** Saves the final counts, in the background unless exiting. */
+	~FCursoryHeatmap();
+
+	/** Saves the counts so far in the background. Skipped if the previous save is still running. */
+	void Flush();
+
+	/** Gets the file this session is saved to. */
+	const FString& GetPath() const
+	{
+		return Path;
+	}
+
+private:
+
+	/** Accumulated counts for one cursor. */
+	struct FGrid
+	{
+		EMouseCursor::Type CursorType{EMouseCursor::Default};
+		FGameplayTag CustomCursorIdentifier;
+		TArray<uint32> Moves;
+		TArray<uint32> Presses;
+	};
+
+	/** Accumulates the samples recorded since the last tick. */
+	bool Tick(float DeltaTime);
+
+	/** Saves the counts on the game thread, waiting for any background save first. Only for exit. */
+	void Save();
+
+	/** Saves the counts on the flush interval. */
+	bool FlushPeriodically(float DeltaTime);
+
+	/** Copies the counts for saving. */
+	FCursoryHeatmapData MakeData() const;
+
+	/** Finds the grid for a cursor, adding it on first sight. */
+	int32 FindOrAddGrid(EMouseCursor::Type CursorType, const FGameplayTag& CustomCursorIdentifier);
+
+	FCursoryMouseSampleReader Reader;
+	FIntPoint Resolution;
+	FString Path;
+	double Duration{0.0};
+
+	TArray<FGrid> Grids;
+
+	FTSTicker::FDelegateHandle TickHandle;
+	FTSTicker::FDelegateHandle FlushHandle;
+	FDelegateHandle PreExitHandle;
+
+	/** Background save in flight, if any. */
+	TFuture<void> PendingSave;
+};
@@ -0,0 +1,86 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryHeatmapMergeCommandlet.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "CursoryModule.h"
+#include "CursoryHeatmap.h"
+
+UCursoryHeatmapMergeCommandlet::UCursoryHeatmapMergeCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UCursoryHeatmapMergeCommandlet::Main(const FString& Params)
+{
+	const FString HeatmapDir = FPaths::ProjectSavedDir() / TEXT("Cursory") / TEXT("Heatmaps");
+
+	FString Input = HeatmapDir;
+	FString Output = HeatmapDir / TEXT("Merged.cursorheat");
+	FString Csv;
+	FParse::Value(*Params, TEXT("Input="), Input);
+	FParse::Value(*Params, TEXT("Output="), Output);
+	FParse::Value(*Params, TEXT("Csv="), Csv);
+
+	TArray<FString> Files;
+	if (IFileManager::Get().DirectoryExists(*Input))
+	{
+		IFileManager::Get().FindFiles(Files, *(Input / TEXT("*.cursorheat")), true, false);
+		for (FString& File : Files)
+		{
+			File = Input / File;
+		}
+	}
+
+	else
+	{
+		Files.Add(Input);
+	}
+
+	// Do not merge a previous merge back in.
+	Files.Remove(Output);
+
+	FCursoryHeatmapData Merged;
+	int32 MergedCount = 0;
+	for (const FString& File : Files)
+	{
+		FCursoryHeatmapData Session;
+		if (!Session.LoadFromFile(File))
+		{
+			UE_LOG(LogCursory, Warning, TEXT("Skipping [%s]: not a valid cursor heatmap."), *File);
+			continue;
+		}
+
+		if (!Merged.Merge(Session))
+		{
+			UE_LOG(LogCursory, Warning, TEXT("Skipping [%s]: resolution %dx%d does not match %dx%d."), *File, Session.Resolution.X, Session.Resolution.Y, Merged.Resolution.X, Merged.Resolution.Y);
+			continue;
+		}
+
+		++MergedCount;
+	}
+
+	if (MergedCount == 0)
+	{
+		UE_LOG(LogCursory, Error, TEXT("No cursor heatmaps found at [%s]."), *Input);
+		return 1;
+	}
+
+	if (!Merged.SaveToFile(Output))
+	{
+		UE_LOG(LogCursory, Error, TEXT("Failed to save merged cursor heatmap to [%s]."), *Output);
+		return 1;
+	}
+
+	if (!Csv.IsEmpty() && !Merged.ExportCsv(Csv))
+	{
+		UE_LOG(LogCursory, Error, TEXT("Failed to export merged cursor heatmap to [%s]."), *Csv);
+		return 1;
+	}
+
+	UE_LOG(LogCursory, Display, TEXT("Merged %d cursor heatmaps (%.0f seconds) into [%s]."), MergedCount, Merged.Duration, *Output);
+	return 0;
+}
@@ -0,0 +1,26 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CursoryHeatmapMergeCommandlet.generated.h"
+
+/**
+ * Merges cursor heatmap sessions (.cursorheat) into one, optionally exporting it to CSV.
+ * Sessions must share a resolution; counts are added per cursor.
+ *
+ * Usage: -run=CursoryHeatmapMerge -Input=<directory or file> -Output=<file> [-Csv=<file>]
+ * Input defaults to Saved/Cursory/Heatmaps, and Output to Saved/Cursory/Heatmaps/Merged.cursorheat.
+ */
+UCLASS()
+class UCursoryHeatmapMergeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UCursoryHeatmapMergeCommandlet();
+
+	int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,225 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryLatencyTracker.h"
+
+#if CURSORY_LATENCY_TRACKING
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "CursoryModule.h"
+
+namespace CursoryLatencyTracker
+{
+	FAutoConsoleCommand DumpCommand(
+		TEXT("Cursory.Latency.Dump"),
+		TEXT("Logs cursor change latency histograms, per request source and stage."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FCursoryLatencyTracker::Get().Dump();
+		}));
+
+	FAutoConsoleCommand ResetCommand(
+		TEXT("Cursory.Latency.Reset"),
+		TEXT("Clears cursor change latency histograms."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FCursoryLatencyTracker::Get().Reset();
+		}));
+
+	FAutoConsoleCommand ExportCsvCommand(
+		TEXT("Cursory.Latency.ExportCsv"),
+		TEXT("Writes cursor change latency histograms to CSV. Optional argument: output path."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString Path = Args.Num() > 0 ? Args[0] : FPaths::ProfilingDir() / TEXT("CursoryLatency.csv");
+			if (FCursoryLatencyTracker::Get().ExportCsv(Path))
+			{
+				UE_LOG(LogCursory, Display, TEXT("Wrote cursor latency histograms to [%s]."), *Path);
+			}
+
+			else
+			{
+				UE_LOG(LogCursory, Warning, TEXT("Failed to write cursor latency histograms to [%s]."), *Path);
+			}
+		}));
+}
+
+FCursoryLatencyTracker& FCursoryLatencyTracker::Get()
+{
+	static FCursoryLatencyTracker Tracker;
+	return Tracker;
+}
+
+void FCursoryLatencyTracker::BeginRequest(int32 UserIndex, ECursoryLatencySource Source)
+{
+	if (UserIndex >= 0 && UserIndex < UCursorySystem::MaxUsers)
+	{
+		// Supersedes any request that is still in flight.
+		FRequest& Request = Requests[UserIndex];
+		Request.Cycles = FPlatformTime::Cycles64();
+		Request.Source = Source;
+		Request.RecordedStages = 0;
+	}
+}
+
+void FCursoryLatencyTracker::RecordStage(int32 UserIndex, ECursoryLatencyStage Stage)
+{
+	if (UserIndex < 0 || UserIndex >= UCursorySystem::MaxUsers)
+	{
+		return;
+	}
+
+	// Called from cursor queries, so bail out as early as possible.
+	FRequest& Request = Requests[UserIndex];
+	const uint32 StageBit = 1 << static_cast<uint32>(Stage);
+	if (!Request.IsActive() || (Request.RecordedStages & StageBit) != 0)
+	{
+		return;
+	}
+
+	// Later stages only count once the change has been evaluated.
+	if (Stage != ECursoryLatencyStage::Evaluate && (Request.RecordedStages & (1 << static_cast<uint32>(ECursoryLatencyStage::Evaluate))) == 0)
+	{
+		return;
+	}
+
+	Request.RecordedStages |= StageBit;
+	const double Microseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - Request.Cycles) * 1000.0;
+	Histograms[static_cast<int32>(Request.Source)][static_cast<int32>(Stage)].Add(Microseconds);
+}
+
+void FCursoryLatencyTracker::RecordSlateTick()
+{
+	for (int32 UserIndex = 0; UserIndex < UCursorySystem::MaxUsers; ++UserIndex)
+	{
+		RecordStage(UserIndex, ECursoryLatencyStage::SlateTick);
+	}
+}
+
+void FCursoryLatencyTracker::Dump() const
+{
+	UE_LOG(LogCursory, Display, TEXT("Cursor change latency (ms, measured from request):"));
+	UE_LOG(LogCursory, Display, TEXT("%-8s %-12s %8s %8s %8s %8s %8s %8s"), TEXT("Source"), TEXT("Stage"), TEXT("Count"), TEXT("Avg"), TEXT("P50"), TEXT("P95"), TEXT("P99"), TEXT("Max"));
+
+	for (int32 Source = 0; Source < NumSources; ++Source)
+	{
+		for (int32 Stage = 0; Stage < NumStages; ++Stage)
+		{
+			const FHistogram& Histogram = Histograms[Source][Stage];
+			if (Histogram.Count > 0)
+			{
+				UE_LOG(LogCursory, Display, TEXT("%-8s %-12s %8u %8.3f %8.3f %8.3f %8.3f %8.3f"),
+					ToString(static_cast<ECursoryLatencySource>(Source)),
+					ToString(static_cast<ECursoryLatencyStage>(Stage)),
+					Histogram.Count,
+					Histogram.Sum / Histogram.Count / 1000.0,
+					Histogram.GetPercentile(0.5),
+					Histogram.GetPercentile(0.95),
+					Histogram.GetPercentile(0.99),
+					Histogram.Max / 1000.0);
+			}
+		}
+	}
+}
+
+void FCursoryLatencyTracker::Reset()
+{
+	for (int32 Source = 0; Source < NumSources; ++Source)
+	{
+		for (int32 Stage = 0; Stage < NumStages; ++Stage)
+		{
+			Histograms[Source][Stage] = FHistogram();
+		}
+	}
+}
+
+bool FCursoryLatencyTracker::ExportCsv(const FString& Path) const
+{
+	FString Csv = TEXT("Source,Stage,Count,AvgMs,P50Ms,P95Ms,P99Ms,MaxMs");
+	for (int32 Bucket = 0; Bucket < FHistogram::NumBuckets; ++Bucket)
+	{
+		Csv += FString::Printf(TEXT(",Under%lluUs"), 1ull << (Bucket + 1));
+	}
+	Csv += LINE_TERMINATOR;
+
+	for (int32 Source = 0; Source < NumSources; ++Source)
+	{
+		for (int32 Stage = 0; Stage < NumStages; ++Stage)
+		{
+			const FHistogram& Histogram = Histograms[Source][Stage];
+			Csv += FString::Printf(TEXT("%s,%s,%u,%.4f,%.4f,%.4f,%.4f,%.4f"),
+				ToString(static_cast<ECursoryLatencySource>(Source)),
+				ToString(static_cast<ECursoryLatencyStage>(Stage)),
+				Histogram.Count,
+				Histogram.Count > 0 ? Histogram.Sum / Histogram.Count / 1000.0 : 0.0,
+				Histogram.GetPercentile(0.5),
+				Histogram.GetPercentile(0.95),
+				Histogram.GetPercentile(0.99),
+				Histogram.Max / 1000.0);
+
+			for (int32 Bucket = 0; Bucket < FHistogram::NumBuckets; ++Bucket)
+			{
+				Csv += FString::Printf(TEXT(",%u"), Histogram.Buckets[Bucket]);
+			}
+			Csv += LINE_TERMINATOR;
+		}
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *Path);
+}
+
+void FCursoryLatencyTracker::FHistogram::Add(double Microseconds)
+{
+	// Bucket N holds latencies under 2^(N+1) microseconds.
+	const int32 Bucket = Microseconds < 2.0 ? 0 : FMath::Min(FMath::FloorLog2(static_cast<uint32>(FMath::Min(Microseconds, static_cast<double>(MAX_uint32)))), NumBuckets - 1);
+	++Buckets[Bucket];
+	++Count;
+	Sum += Microseconds;
+	Max = FMath::Max(Max, Microseconds);
+}
+
+double FCursoryLatencyTracker::FHistogram::GetPercentile(double Percentile) const
+{
+	const uint32 Target = FMath::CeilToInt(Count * Percentile);
+	uint32 Seen = 0;
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		Seen += Buckets[Bucket];
+		if (Seen >= Target && Seen > 0)
+		{
+			return FMath::Min(static_cast<double>(1ull << (Bucket + 1)), Max) / 1000.0;
+		}
+	}
+
+	return Max / 1000.0;
+}
+
+const TCHAR* FCursoryLatencyTracker::ToString(ECursoryLatencySource Source)
+{
+	switch (Source)
+	{
+	case ECursoryLatencySource::Push: return TEXT("Push");
+	case ECursoryLatencySource::Modify: return TEXT("Modify");
+	case ECursoryLatencySource::Remove: return TEXT("Remove");
+	case ECursoryLatencySource::Pop: return TEXT("Pop");
+	case ECursoryLatencySource::Reset: return TEXT("Reset");
+	case ECursoryLatencySource::Base: return TEXT("Base");
+	default: return TEXT("Unknown");
+	}
+}
+
+const TCHAR* FCursoryLatencyTracker::ToString(ECursoryLatencyStage Stage)
+{
+	switch (Stage)
+	{
+	case ECursoryLatencyStage::Evaluate: return TEXT("Evaluate");
+	case ECursoryLatencyStage::Mount: return TEXT("Mount");
+	case ECursoryLatencyStage::Controller: return TEXT("Controller");
+	case ECursoryLatencyStage::WidgetQuery: return TEXT("WidgetQuery");
+	case ECursoryLatencyStage::SlateTick: return TEXT("SlateTick");
+	default: return TEXT("Unknown");
+	}
+}
+
+#endif
@@ -0,0 +1,126 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CursorySystem.h"
+
+/** Latency tracking is compiled out of shipping builds. */
+#define CURSORY_LATENCY_TRACKING !UE_BUILD_SHIPPING
+
+#if CURSORY_LATENCY_TRACKING
+
+/** What requested a cursor change. */
+enum class ECursoryLatencySource : uint8
+{
+	Push,
+	Modify,
+	Remove,
+	Pop,
+	Reset,
+	Base,
+	Count
+};
+
+/** How far a cursor change has made it, measured from its request. */
+enum class ECursoryLatencyStage : uint8
+{
+	/** EvaluateCursorStack resolved the new top of the stack. */
+	Evaluate,
+
+	/** The custom cursor was set on the platform cursor (SetTypeShape). */
+	Mount,
+
+	/** A conformed PlayerController's cursor was updated. */
+	Controller,
+
+	/** A conformed widget's cursor was queried by Slate. */
+	WidgetQuery,
+
+	/** Slate finished the next tick (and with it, the cursor query). */
+	SlateTick,
+	Count
+};
+
+/**
+ * Measures how long cursor changes take to reach the screen.
+ * Each request is timestamped per user, and every stage it reaches afterwards
+ * is recorded (once) into a histogram for its source and stage.
+ * A request that is superseded before reaching a stage is not recorded for it.
+ *
+ * Console commands:
+ * - Cursory.Latency.Dump: logs the histograms.
+ * - Cursory.Latency.Reset: clears the histograms.
+ * - Cursory.Latency.ExportCsv [Path]: writes the histograms to CSV (Saved/Profiling by default).
+ */
+class FCursoryLatencyTracker
+{
+public:
+
+	static FCursoryLatencyTracker& Get();
+
+	/** Timestamps a cursor change request for a user. */
+	void BeginRequest(int32 UserIndex, ECursoryLatencySource Source);
+
+	/** Records a stage reached by a user's current request. */
+	void RecordStage(int32 UserIndex, ECursoryLatencyStage Stage);
+
+	/** Records the Slate tick stage for every request that has been evaluated. */
+	void RecordSlateTick();
+
+	void Dump() const;
+	void Reset();
+	bool ExportCsv(const FString& Path) const;
+
+private:
+
+	/** Log2 histogram of latencies, in microseconds. */
+	struct FHistogram
+	{
+		static constexpr int32 NumBuckets = 24;
+
+		void Add(double Microseconds);
+
+		/** Gets an upper bound (in milliseconds) for the specified percentile. */
+		double GetPercentile(double Percentile) const;
+
+		uint32 Buckets[NumBuckets]{};
+		uint32 Count{0};
+		double Sum{0.0};
+		double Max{0.0};
+	};
+
+	/** The latest request of a user. */
+	struct FRequest
+	{
+		uint64 Cycles{0};
+		ECursoryLatencySource Source{ECursoryLatencySource::Push};
+
+		/** Stages already recorded, as bits. */
+		uint32 RecordedStages{0};
+
+		bool IsActive() const
+		{
+			return Cycles != 0;
+		}
+	};
+
+	static constexpr int32 NumSources = static_cast<int32>(ECursoryLatencySource::Count);
+	static constexpr int32 NumStages = static_cast<int32>(ECursoryLatencyStage::Count);
+
+	static const TCHAR* ToString(ECursoryLatencySource Source);
+	static const TCHAR* ToString(ECursoryLatencyStage Stage);
+
+	FRequest Requests[UCursorySystem::MaxUsers];
+	FHistogram Histograms[NumSources][NumStages];
+};
+
+#define CURSORY_LATENCY_REQUEST(UserIndex, Source) FCursoryLatencyTracker::Get().BeginRequest(UserIndex, ECursoryLatencySource::Source)
+#define CURSORY_LATENCY_STAGE(UserIndex, Stage) FCursoryLatencyTracker::Get().RecordStage(UserIndex, ECursoryLatencyStage::Stage)
+
+#else
+
+#define CURSORY_LATENCY_REQUEST(UserIndex, Source)
+#define CURSORY_LATENCY_STAGE(UserIndex, Stage)
+
+#endif
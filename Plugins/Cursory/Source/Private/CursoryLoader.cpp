@@ -0,0 +1,284 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryLoader.h"
+#include "GenericPlatform/ICursor.h"
+#include "Misc/Paths.h"
+#include "IImageWrapperModule.h"
+#include "HAL/FileManager.h"
+#include "IImageWrapper.h"
+#include "Misc/FileHelper.h"
+#include "HAL/PlatformApplicationMisc.h"
+#include "Modules/ModuleManager.h"
+#include "CursoryModule.h"
+#include "CursoryDecodeCache.h"
+#include "Misc/SecureHash.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#elif PLATFORM_MAC
+#include <CoreFoundation/CoreFoundation.h>
+#elif PLATFORM_LINUX
+#include "SDL.h"
+#endif
+
+struct FPNGConverter
+{
+	/**
+	 * Describes PNG file data that can be used to
+	 * create a cursor.
+	 */
+	struct FPngFileData
+	{
+		FString FileName;
+		double ScaleFactor;
+		TArray<uint8> FileData;
+
+		FPngFileData()
+			: ScaleFactor(1.0)
+		{
+		}
+	};
+
+	static bool DecodeCursorFromPngs(FCursoryDecodedCursor& Decoded, float PlatformScaleFactor)
+	{
+		TArray<TSharedPtr<FPngFileData>> CursorPngFiles;
+		if (!LoadAvailableCursorPngs(CursorPngFiles, Decoded.FullPath))
+		{
+			return false;
+		}
+
+		check(CursorPngFiles.Num() > 0);
+		TSharedPtr<FPngFileData> NearestCursor = CursorPngFiles[0];
+		for (TSharedPtr<FPngFileData>& FileData : CursorPngFiles)
+		{
+			const float NewDelta = FMath::Abs(FileData->ScaleFactor - PlatformScaleFactor);
+			if (NewDelta < FMath::Abs(NearestCursor->ScaleFactor - PlatformScaleFactor))
+			{
+				NearestCursor = FileData;
+			}
+		}
+
+		// Unchanged art at the same decode parameters can skip decoding entirely.
+		const bool bUseCache = FCursoryDecodeCache::IsEnabled();
+		Decoded.CacheKey = FCursoryDecodeCache::MakeKey(NearestCursor->FileData, TEXT("RGBA8"));
+		if (bUseCache && FCursoryDecodeCache::Get(Decoded.CacheKey, Decoded))
+		{
+			return true;
+		}
+
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+		TSharedPtr<IImageWrapper>PngImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+
+		if (PngImageWrapper.IsValid() && PngImageWrapper->SetCompressed(NearestCursor->FileData.GetData(), NearestCursor->FileData.Num()))
+		{
+			if (PngImageWrapper->GetRaw(ERGBFormat::RGBA, 8, Decoded.Pixels))
+			{
+				Decoded.Width = PngImageWrapper->GetWidth();
+				Decoded.Height = PngImageWrapper->GetHeight();
+				if (bUseCache)
+				{
+					FCursoryDecodeCache::Put(Decoded.CacheKey, Decoded);
+				}
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	static bool LoadAvailableCursorPngs(TArray<TSharedPtr<FPngFileData>>& Results, const FString& InPathToCursorWithoutExtension)
+	{
+		FString CursorsWithSizeSearch = FPaths::GetCleanFilename(InPathToCursorWithoutExtension) + TEXT("*.png");
+
+		TArray<FString> PngCursorFiles;
+		IFileManager::Get().FindFilesRecursive(PngCursorFiles, *FPaths::GetPath(InPathToCursorWithoutExtension), *CursorsWithSizeSearch, true, false, false);
+
+		bool bFoundCursor = false;
+
+		for (const FString& FullCursorPath : PngCursorFiles)
+		{
+			FString CursorFile = FPaths::GetBaseFilename(FullCursorPath);
+
+			FString Dummy;
+			FString ScaleFactorSection;
+			FString ScaleFactor;
+
+			if (CursorFile.Split(TEXT("@"), &Dummy, &ScaleFactorSection, ESearchCase::IgnoreCase, ESearchDir::FromEnd))
+			{
+				if (ScaleFactorSection.Split(TEXT("x"), &ScaleFactor, &Dummy) == false)
+				{
+					ScaleFactor = ScaleFactorSection;
+				}
+			}
+			else
+			{
+				ScaleFactor = TEXT("1");
+			}
+
+			if (FCString::IsNumeric(*ScaleFactor) == false)
+			{
+				UE_LOG(LogInit, Error, TEXT("Failed to load cursor '%s', non-numeric characters in the scale factor."), *FullCursorPath);
+				continue;
+			}
+
+			TSharedPtr<FPngFileData> PngFileData = MakeShared<FPngFileData>();
+			PngFileData->FileName = FullCursorPath;
+			PngFileData->ScaleFactor = FCString::Atof(*ScaleFactor);
+
+			if (FFileHelper::LoadFileToArray(PngFileData->FileData, *FullCursorPath, FILEREAD_Silent))
+			{
+				UE_LOG(LogInit, Log, TEXT("Loading Cursor '%s'."), *FullCursorPath);
+			}
+
+			Results.Add(PngFileData);
+
+			bFoundCursor = true;
+		}
+
+		Results.StableSort([](const TSharedPtr<FPngFileData>& InFirst, const TSharedPtr<FPngFileData>& InSecond) -> bool
+		{
+			return InFirst->ScaleFactor < InSecond->ScaleFactor;
+		});
+
+		return bFoundCursor;
+	}
+};
+
+namespace CursoryLoader
+{
+	/** Finds a cursor file the platform can load directly at the path. Returns an empty string if there is none. */
+	FString FindNativeCursorFile(const FString& InPathToCursorWithoutExtension)
+	{
+#if PLATFORM_WINDOWS || PLATFORM_MAC
+#if PLATFORM_WINDOWS
+		const TCHAR* Extensions[] = {TEXT(".ani"), TEXT(".cur")};
+#else
+		const TCHAR* Extensions[] = {TEXT(".tiff")};
+#endif
+		for (const TCHAR* Extension : Extensions)
+		{
+			const FString Candidate = InPathToCursorWithoutExtension + Extension;
+			if (FPaths::FileExists(Candidate))
+			{
+				return Candidate;
+			}
+		}
+#endif
+
+		return FString();
+	}
+
+	/** Hashes what the platform will see of a cursor: its pixels (or native file) and hotspot. */
+	FString MakeContentKey(const FCursoryDecodedCursor& Decoded, const FString& NativeFile)
+	{
+		FSHA1 Sha;
+		if (Decoded.IsDecoded())
+		{
+			Sha.Update(reinterpret_cast<const uint8*>(&Decoded.Width), sizeof(Decoded.Width));
+			Sha.Update(reinterpret_cast<const uint8*>(&Decoded.Height), sizeof(Decoded.Height));
+			Sha.Update(Decoded.Pixels.GetData(), Decoded.Pixels.Num());
+		}
+
+		else
+		{
+			TArray<uint8> FileData;
+			if (NativeFile.IsEmpty() || !FFileHelper::LoadFileToArray(FileData, *NativeFile, FILEREAD_Silent))
+			{
+				return FString();
+			}
+			Sha.Update(FileData.GetData(), FileData.Num());
+		}
+
+		Sha.Update(reinterpret_cast<const uint8*>(&Decoded.Hotspot), sizeof(Decoded.Hotspot));
+		Sha.Final();
+
+		FSHAHash Hash;
+		Sha.GetHash(Hash.Hash);
+		return Hash.ToString();
+	}
+}
+
+FCursoryDecodedCursor FCursoryLoader::Decode(const FCursorInfo& Spec, float PlatformScaleFactor, TMap<FString, FString>* SeenSources /* = nullptr */)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	FCursoryDecodedCursor Decoded;
+	Decoded.Identifier = Spec.Identifier;
+	Decoded.FullPath = FPaths::ProjectContentDir() / Spec.Path;
+
+	// Validate hot spot.
+	Decoded.Hotspot = Spec.Hotspot;
+	ensure(Decoded.Hotspot.X >= 0.0f && Decoded.Hotspot.X <= 1.0f);
+	ensure(Decoded.Hotspot.Y >= 0.0f && Decoded.Hotspot.Y <= 1.0f);
+	Decoded.Hotspot.X = FMath::Clamp(Decoded.Hotspot.X, 0.0f, 1.0f);
+	Decoded.Hotspot.Y = FMath::Clamp(Decoded.Hotspot.Y, 0.0f, 1.0f);
+
+	// Sources shared by several identifiers only need to be read once.
+	const FString SourceKey = FString::Printf(TEXT("%s|%s"), *Decoded.FullPath, *Decoded.Hotspot.ToString());
+	if (SeenSources)
+	{
+		if (const FString* ContentKey = SeenSources->Find(SourceKey))
+		{
+			Decoded.ContentKey = *ContentKey;
+			return Decoded;
+		}
+	}
+
+	// Native files take priority, and are left for the platform to load.
+	const FString NativeFile = CursoryLoader::FindNativeCursorFile(Decoded.FullPath);
+	if (NativeFile.IsEmpty())
+	{
+		FPNGConverter::DecodeCursorFromPngs(Decoded, PlatformScaleFactor);
+	}
+
+	Decoded.ContentKey = CursoryLoader::MakeContentKey(Decoded, NativeFile);
+	if (SeenSources && !Decoded.ContentKey.IsEmpty())
+	{
+		SeenSources->Add(SourceKey, Decoded.ContentKey);
+	}
+
+	Decoded.DecodeSeconds = FPlatformTime::Seconds() - StartTime;
+	return Decoded;
+}
+
+void* FCursoryLoader::CreateHandle(ICursor& PlatformCursor, const FCursoryDecodedCursor& Decoded)
+{
+	check(IsInGameThread());
+
+	if (Decoded.IsDecoded() && PlatformCursor.IsCreateCursorFromRGBABufferSupported())
+	{
+		return PlatformCursor.CreateCursorFromRGBABuffer((const FColor*)Decoded.Pixels.GetData(), Decoded.Width, Decoded.Height, Decoded.Hotspot);
+	}
+
+	return PlatformCursor.CreateCursorFromFile(Decoded.FullPath, Decoded.Hotspot);
+}
+
+void FCursoryLoader::DestroyHandle(void* Handle)
+{
+	check(IsInGameThread());
+
+	if (!Handle)
+	{
+		return;
+	}
+
+	// ICursor has no way to free the handles it creates, so this mirrors each platform's creation.
+#if PLATFORM_WINDOWS
+	::DestroyCursor(static_cast<HCURSOR>(Handle));
+#elif PLATFORM_MAC
+	// Handles are retained NSCursors.
+	CFRelease(Handle);
+#elif PLATFORM_LINUX
+	SDL_FreeCursor(static_cast<SDL_Cursor*>(Handle));
+#endif
+}
+
+void* FCursoryLoader::Load(ICursor& PlatformCursor, const FCursorInfo& Spec)
+{
+	return CreateHandle(PlatformCursor, Decode(Spec, GetPlatformScaleFactor()));
+}
+
+float FCursoryLoader::GetPlatformScaleFactor()
+{
+	return FPlatformApplicationMisc::GetDPIScaleFactorAtPoint(0, 0);
+}
@@ -0,0 +1,83 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "CursoryTypes.h"
+
+class ICursor;
+
+/**
+ * A cursor that has been read (and, for raster images, decoded)
+ * and is ready to be created on the platform.
+ */
+struct FCursoryDecodedCursor
+{
+	/** The identifying tag for this cursor. */
+	FGameplayTag Identifier;
+
+	/** Full path to the cursor, without extension. */
+	FString FullPath;
+
+	/** Normalized hotspot. */
+	FVector2D Hotspot{FVector2D::ZeroVector};
+
+	/**
+	 * Decoded RGBA pixels.
+	 * Empty for platform-native cursor files (.ani, .cur, .tiff), which are created from file.
+	 */
+	TArray64<uint8> Pixels;
+
+	int32 Width{0};
+	int32 Height{0};
+
+	/** Time spent reading and decoding, in seconds. */
+	double DecodeSeconds{0.0};
+
+	/** Decode cache key of the source image. Empty if the cursor was not decoded from an image. */
+	FString CacheKey;
+
+	/** 
+	 * Hash of the cursor's content (decoded pixels or native file, plus hotspot).
+	 * Cursors with equal keys can share a platform handle. Empty if the cursor could not be read.
+	 */
+	FString ContentKey;
+
+	bool IsDecoded() const
+	{
+		return Pixels.Num() > 0;
+	}
+};
+
+/**
+ * Loads cursors in two steps, so that the expensive part can happen off the game thread:
+ * - Decode reads and decodes image data, and is safe to call from any thread.
+ * - CreateHandle creates the platform cursor, and must be called on the game thread.
+ *
+ * Load priority:
+ * - Windows: .ani -> .cur -> .png
+ * - Mac: .tiff -> .png
+ * - Linux: .png
+ */
+struct FCursoryLoader
+{
+	/** 
+	 * Reads and decodes the cursor described by the spec.
+	 * If SeenSources is provided, a source (path and hotspot) already decoded through it
+	 * is not read again; only its content key is filled in, so that it can share a handle.
+	 */
+	static FCursoryDecodedCursor Decode(const FCursorInfo& Spec, float PlatformScaleFactor, TMap<FString, FString>* SeenSources = nullptr);
+
+	/** Creates a platform cursor handle from a decoded cursor. Returns null on failure. */
+	static void* CreateHandle(ICursor& PlatformCursor, const FCursoryDecodedCursor& Decoded);
+
+	/** Frees a platform cursor handle. The handle must not be mounted. Game thread only. */
+	static void DestroyHandle(void* Handle);
+
+	/** Decodes and creates a platform cursor handle in one go. Returns null on failure. */
+	static void* Load(ICursor& PlatformCursor, const FCursorInfo& Spec);
+
+	/** Gets the scale factor used to pick between DPI variants of a cursor. Game thread only. */
+	static float GetPlatformScaleFactor();
+};
@@ -0,0 +1,47 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryMouseSampler.h"
+#include "Input/Events.h"
+
+FCursoryMouseSampler::FCursoryMouseSampler(const TSharedRef<FCursoryMouseSampleBuffer>& InBuffer)
+	: Buffer(InBuffer)
+{
+	// no op
+}
+
+bool FCursoryMouseSampler::HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	const TSharedPtr<FCursoryMouseSampleBuffer> PinnedBuffer = Buffer.Pin();
+	if (!PinnedBuffer.IsValid())
+	{
+		return false;
+	}
+
+	FCursoryMouseSample Sample;
+	Sample.Time = FPlatformTime::Seconds();
+	Sample.ScreenPosition = MouseEvent.GetScreenSpacePosition();
+	Sample.Delta = MouseEvent.GetCursorDelta();
+	Sample.UserIndex = MouseEvent.GetUserIndex();
+	PinnedBuffer->Record(Sample);
+
+	// Only observing; let the event through.
+	return false;
+}
+
+bool FCursoryMouseSampler::HandleMouseButtonDownEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	const TSharedPtr<FCursoryMouseSampleBuffer> PinnedBuffer = Buffer.Pin();
+	if (!PinnedBuffer.IsValid())
+	{
+		return false;
+	}
+
+	FCursoryMouseSample Sample;
+	Sample.Time = FPlatformTime::Seconds();
+	Sample.ScreenPosition = MouseEvent.GetScreenSpacePosition();
+	Sample.UserIndex = MouseEvent.GetUserIndex();
+	Sample.bPressed = true;
+	PinnedBuffer->Record(Sample);
+
+	return false;
+}
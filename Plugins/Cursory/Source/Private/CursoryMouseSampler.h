@@ -0,0 +1,37 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/Application/IInputProcessor.h"
+#include "CursoryMouseSamples.h"
+
+/**
+ * Records every mouse move and button press Slate processes into a shared sample buffer,
+ * so that sub-frame motion is not lost to per-tick polling.
+ * The buffer is owned by its readers; once the last is gone, nothing is recorded.
+ * Never consumes input.
+ */
+class FCursoryMouseSampler : public IInputProcessor
+{
+public:
+
+	explicit FCursoryMouseSampler(const TSharedRef<FCursoryMouseSampleBuffer>& InBuffer);
+
+	/** Gets the buffer samples are recorded into, or null once it has no readers left. */
+	TSharedPtr<FCursoryMouseSampleBuffer> GetBuffer() const
+	{
+		return Buffer.Pin();
+	}
+
+	//~ Begin IInputProcessor Interface
+	void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override {}
+	bool HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	bool HandleMouseButtonDownEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	const TCHAR* GetDebugName() const override { return TEXT("CursoryMouseSampler"); }
+	//~ End IInputProcessor Interface
+
+private:
+
+	TWeakPtr<FCursoryMouseSampleBuffer> Buffer;
+};
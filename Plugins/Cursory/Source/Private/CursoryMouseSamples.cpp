@@ -0,0 +1,80 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryMouseSamples.h"
+
+FCursoryMouseSampleBuffer::FCursoryMouseSampleBuffer()
+{
+	Samples.SetNum(Capacity);
+}
+
+void FCursoryMouseSampleBuffer::Record(const FCursoryMouseSample& Sample)
+{
+	// Single producer, so the position can be read relaxed; publishing it releases the sample.
+	const uint64 Position = WritePosition.load(std::memory_order_relaxed);
+	Samples[Position & (Capacity - 1)] = Sample;
+	WritePosition.store(Position + 1, std::memory_order_release);
+}
+
+FCursoryMouseSampleReader::FCursoryMouseSampleReader(TSharedRef<const FCursoryMouseSampleBuffer> InBuffer)
+	: Buffer(InBuffer)
+	, ReadPosition(InBuffer->GetWritePosition())
+{
+	// no op
+}
+
+FCursoryMouseSampleSpan FCursoryMouseSampleReader::Read()
+{
+	if (!Buffer.IsValid())
+	{
+		return FCursoryMouseSampleSpan();
+	}
+
+	const uint64 End = Buffer->GetWritePosition();
+	const uint64 Begin = FMath::Max(ReadPosition, End > FCursoryMouseSampleBuffer::Capacity ? End - FCursoryMouseSampleBuffer::Capacity : 0);
+	DroppedCount += Begin - ReadPosition;
+	ReadPosition = End;
+	return MakeSpan(Begin, End);
+}
+
+FCursoryMouseSampleSpan FCursoryMouseSampleReader::Peek() const
+{
+	if (!Buffer.IsValid())
+	{
+		return FCursoryMouseSampleSpan();
+	}
+
+	const uint64 End = Buffer->GetWritePosition();
+	const uint64 Begin = FMath::Max(ReadPosition, End > FCursoryMouseSampleBuffer::Capacity ? End - FCursoryMouseSampleBuffer::Capacity : 0);
+	return MakeSpan(Begin, End);
+}
+
+void FCursoryMouseSampleReader::SkipToLatest()
+{
+	if (Buffer.IsValid())
+	{
+		ReadPosition = Buffer->GetWritePosition();
+	}
+}
+
+FCursoryMouseSampleSpan FCursoryMouseSampleReader::MakeSpan(uint64 Begin, uint64 End) const
+{
+	FCursoryMouseSampleSpan Span;
+	if (Begin == End)
+	{
+		return Span;
+	}
+
+	// Split at the end of the ring, if the range wraps.
+	const FCursoryMouseSample* First = &Buffer->GetSample(Begin);
+	const uint64 BeginIndex = Begin & (FCursoryMouseSampleBuffer::Capacity - 1);
+	const uint64 Count = End - Begin;
+	const uint64 FirstCount = FMath::Min(Count, FCursoryMouseSampleBuffer::Capacity - BeginIndex);
+
+	Span.First = TArrayView<const FCursoryMouseSample>(First, static_cast<int32>(FirstCount));
+	if (FirstCount < Count)
+	{
+		Span.Second = TArrayView<const FCursoryMouseSample>(&Buffer->GetSample(0), static_cast<int32>(Count - FirstCount));
+	}
+
+	return Span;
+}
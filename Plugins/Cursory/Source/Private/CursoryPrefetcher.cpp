@@ -0,0 +1,242 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryPrefetcher.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "CursoryModule.h"
+
+namespace CursoryPrefetcher
+{
+	constexpr int32 Version = 1;
+
+	/** Cursors prefetched per change. */
+	constexpr int32 MaxPredictions = 2;
+
+	/** Transitions rarer than this (as a fraction of those from the same cursor) are not prefetched. */
+	constexpr float MinProbability = 0.1f;
+
+	/** Counts in a row are halved past this total, so that old habits fade. */
+	constexpr uint32 MaxRowTotal = 1 << 16;
+
+	FString GetTransitionsPath()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("Cursory") / TEXT("CursorTransitions.bin");
+	}
+
+	FAutoConsoleCommand DumpCommand(
+		TEXT("Cursory.Prefetch.Dump"),
+		TEXT("Logs cursor prefetch hit/miss counts and the most frequent cursor transitions."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FCursoryPrefetcher::Get().Dump();
+		}));
+
+	FAutoConsoleCommand ResetCommand(
+		TEXT("Cursory.Prefetch.Reset"),
+		TEXT("Clears cursor prefetch counts and learned cursor transitions."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FCursoryPrefetcher::Get().Reset();
+		}));
+}
+
+FCursoryPrefetcher& FCursoryPrefetcher::Get()
+{
+	static FCursoryPrefetcher Prefetcher;
+	return Prefetcher;
+}
+
+void FCursoryPrefetcher::RecordTransition(const FGameplayTag& From, const FGameplayTag& To)
+{
+	if (From == To || !To.IsValid())
+	{
+		return;
+	}
+
+	FTransitionRow& Row = Transitions.FindOrAdd(From);
+	++Row.FindOrAdd(To);
+
+	uint32 Total = 0;
+	for (const TPair<FGameplayTag, uint32>& Count : Row)
+	{
+		Total += Count.Value;
+	}
+
+	if (Total > CursoryPrefetcher::MaxRowTotal)
+	{
+		for (TPair<FGameplayTag, uint32>& Count : Row)
+		{
+			Count.Value /= 2;
+		}
+	}
+}
+
+void FCursoryPrefetcher::GetLikelyNext(const FGameplayTag& From, TArray<FGameplayTag, TInlineAllocator<4>>& OutIdentifiers) const
+{
+	OutIdentifiers.Reset();
+
+	const FTransitionRow* Row = Transitions.Find(From);
+	if (!Row)
+	{
+		return;
+	}
+
+	uint32 Total = 0;
+	for (const TPair<FGameplayTag, uint32>& Count : *Row)
+	{
+		Total += Count.Value;
+	}
+
+	// Keep the most frequent few, in order.
+	TArray<TPair<FGameplayTag, uint32>, TInlineAllocator<CursoryPrefetcher::MaxPredictions + 1>> Best;
+	for (const TPair<FGameplayTag, uint32>& Count : *Row)
+	{
+		if (Count.Value < Total * CursoryPrefetcher::MinProbability)
+		{
+			continue;
+		}
+
+		int32 Index = 0;
+		while (Index < Best.Num() && Best[Index].Value >= Count.Value)
+		{
+			++Index;
+		}
+
+		if (Index < CursoryPrefetcher::MaxPredictions)
+		{
+			Best.Insert(Count, Index);
+			Best.SetNum(FMath::Min(Best.Num(), CursoryPrefetcher::MaxPredictions));
+		}
+	}
+
+	for (const TPair<FGameplayTag, uint32>& Count : Best)
+	{
+		OutIdentifiers.Add(Count.Key);
+	}
+}
+
+void FCursoryPrefetcher::RecordPrefetch(const FGameplayTag& Identifier)
+{
+	Prefetched.Add(Identifier);
+	++PrefetchCount;
+}
+
+void FCursoryPrefetcher::RecordMount(const FGameplayTag& Identifier, bool bWarm)
+{
+	if (!bWarm)
+	{
+		++MissCount;
+		Prefetched.Remove(Identifier);
+	}
+
+	else if (Prefetched.Remove(Identifier) > 0)
+	{
+		++HitCount;
+	}
+}
+
+void FCursoryPrefetcher::LoadTransitions()
+{
+	if (!PreExitHandle.IsValid())
+	{
+		PreExitHandle = FCoreDelegates::OnPreExit.AddRaw(this, &FCursoryPrefetcher::SaveTransitions);
+	}
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *CursoryPrefetcher::GetTransitionsPath(), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(Bytes);
+	int32 Version = 0;
+	TMap<FString, TMap<FString, uint32>> SavedTransitions;
+	Reader << Version;
+	if (Version != CursoryPrefetcher::Version)
+	{
+		return;
+	}
+
+	Reader << SavedTransitions;
+	if (Reader.IsError())
+	{
+		return;
+	}
+
+	// Tags that no longer exist are dropped.
+	for (const TPair<FString, TMap<FString, uint32>>& SavedRow : SavedTransitions)
+	{
+		const FGameplayTag From = FGameplayTag::RequestGameplayTag(FName(*SavedRow.Key), false);
+		if (!From.IsValid() && !SavedRow.Key.IsEmpty())
+		{
+			continue;
+		}
+
+		FTransitionRow& Row = Transitions.FindOrAdd(From);
+		for (const TPair<FString, uint32>& SavedCount : SavedRow.Value)
+		{
+			const FGameplayTag To = FGameplayTag::RequestGameplayTag(FName(*SavedCount.Key), false);
+			if (To.IsValid())
+			{
+				Row.FindOrAdd(To) += SavedCount.Value;
+			}
+		}
+	}
+}
+
+void FCursoryPrefetcher::SaveTransitions() const
+{
+	// Saved by name, since tag indices differ between builds.
+	TMap<FString, TMap<FString, uint32>> SavedTransitions;
+	for (const TPair<FGameplayTag, FTransitionRow>& Row : Transitions)
+	{
+		TMap<FString, uint32>& SavedRow = SavedTransitions.Add(Row.Key.IsValid() ? Row.Key.ToString() : FString());
+		for (const TPair<FGameplayTag, uint32>& Count : Row.Value)
+		{
+			SavedRow.Add(Count.Key.ToString(), Count.Value);
+		}
+	}
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	int32 Version = CursoryPrefetcher::Version;
+	Writer << Version << SavedTransitions;
+
+	FFileHelper::SaveArrayToFile(Bytes, *CursoryPrefetcher::GetTransitionsPath());
+}
+
+void FCursoryPrefetcher::Dump() const
+{
+	const uint32 MountCount = HitCount + MissCount;
+	UE_LOG(LogCursory, Display, TEXT("Cursor prefetch: %u prefetches, %u hits, %u misses (%.1f%% of on-demand mounts warm)."),
+		PrefetchCount, HitCount, MissCount, MountCount > 0 ? 100.0 * HitCount / MountCount : 0.0);
+
+	for (const TPair<FGameplayTag, FTransitionRow>& Row : Transitions)
+	{
+		TArray<FGameplayTag, TInlineAllocator<4>> LikelyNext;
+		GetLikelyNext(Row.Key, LikelyNext);
+		if (LikelyNext.Num() > 0)
+		{
+			TArray<FString> Names;
+			for (const FGameplayTag& Identifier : LikelyNext)
+			{
+				Names.Add(FString::Printf(TEXT("%s (%u)"), *Identifier.ToString(), Row.Value.FindRef(Identifier)));
+			}
+
+			UE_LOG(LogCursory, Display, TEXT("  [%s] -> %s"), Row.Key.IsValid() ? *Row.Key.ToString() : TEXT("None"), *FString::Join(Names, TEXT(", ")));
+		}
+	}
+}
+
+void FCursoryPrefetcher::Reset()
+{
+	Transitions.Reset();
+	Prefetched.Reset();
+	PrefetchCount = 0;
+	HitCount = 0;
+	MissCount = 0;
+}
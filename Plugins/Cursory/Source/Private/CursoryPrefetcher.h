@@ -0,0 +1,62 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+ * Learns which custom cursor tends to follow which, so that likely next cursors
+ * can be loaded before their first use.
+ * Transitions are counted as the cursor user's custom cursor changes (an empty tag stands for no custom cursor),
+ * and can be persisted between sessions, to Saved/Cursory/CursorTransitions.bin.
+ *
+ * Mounts are counted as hits when a prefetched cursor was warm,
+ * and as misses when an on-demand cursor still had to be loaded.
+ *
+ * Console commands:
+ * - Cursory.Prefetch.Dump: logs hit/miss counts and the most frequent transitions.
+ * - Cursory.Prefetch.Reset: clears counts and transitions.
+ */
+class FCursoryPrefetcher
+{
+public:
+
+	static FCursoryPrefetcher& Get();
+
+	/** Records a change of custom cursor. */
+	void RecordTransition(const FGameplayTag& From, const FGameplayTag& To);
+
+	/** Gets the cursors most likely to follow a cursor, most likely first. */
+	void GetLikelyNext(const FGameplayTag& From, TArray<FGameplayTag, TInlineAllocator<4>>& OutIdentifiers) const;
+
+	/** Records that a cursor is being loaded ahead of use. */
+	void RecordPrefetch(const FGameplayTag& Identifier);
+
+	/** Records a mount of a custom cursor, and whether its handle was ready. */
+	void RecordMount(const FGameplayTag& Identifier, bool bWarm);
+
+	/** Loads persisted transitions, and saves them again on exit. */
+	void LoadTransitions();
+
+	void SaveTransitions() const;
+
+	void Dump() const;
+	void Reset();
+
+private:
+
+	/** Transition counts from one cursor, by next cursor. */
+	using FTransitionRow = TMap<FGameplayTag, uint32>;
+
+	TMap<FGameplayTag, FTransitionRow> Transitions;
+
+	/** Cursors prefetched but not mounted yet. */
+	TSet<FGameplayTag> Prefetched;
+
+	uint32 PrefetchCount{0};
+	uint32 HitCount{0};
+	uint32 MissCount{0};
+
+	FDelegateHandle PreExitHandle;
+};
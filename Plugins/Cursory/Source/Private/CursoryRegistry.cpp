@@ -0,0 +1,82 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryRegistry.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+
+namespace CursoryRegistry
+{
+	const FName IdentifiersTag(TEXT("CursoryIdentifiers"));
+	const FName LoadPriorityTag(TEXT("CursoryLoadPriority"));
+	const FName RegisterAtRuntimeTag(TEXT("CursoryRegisterAtRuntime"));
+}
+
+void UCursoryRegistry::FindRegistries(TArray<FAssetData>& OutRegistries)
+{
+	const IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.GetAssetsByClass(UCursoryRegistry::StaticClass()->GetFName(), OutRegistries, true);
+
+	OutRegistries.RemoveAll([](const FAssetData& Registry)
+	{
+		FString TagValue;
+		return Registry.GetTagValue(CursoryRegistry::RegisterAtRuntimeTag, TagValue) && TagValue.ToBool();
+	});
+}
+
+TArray<FGameplayTag> UCursoryRegistry::GetIdentifiers(const FAssetData& Registry)
+{
+	TArray<FGameplayTag> Identifiers;
+
+	FString TagValue;
+	if (Registry.GetTagValue(CursoryRegistry::IdentifiersTag, TagValue))
+	{
+		TArray<FString> TagNames;
+		TagValue.ParseIntoArray(TagNames, TEXT(","));
+		for (const FString& TagName : TagNames)
+		{
+			const FGameplayTag Identifier = FGameplayTag::RequestGameplayTag(FName(*TagName), false);
+			if (Identifier.IsValid())
+			{
+				Identifiers.Add(Identifier);
+			}
+		}
+	}
+
+	return Identifiers;
+}
+
+ECursorLoadPriority UCursoryRegistry::GetLoadPriority(const FAssetData& Registry)
+{
+	FString TagValue;
+	if (Registry.GetTagValue(CursoryRegistry::LoadPriorityTag, TagValue))
+	{
+		const int64 Value = StaticEnum<ECursorLoadPriority>()->GetValueByNameString(TagValue);
+		if (Value != INDEX_NONE)
+		{
+			return static_cast<ECursorLoadPriority>(Value);
+		}
+	}
+
+	// Registries saved without tags have to be loaded to find out.
+	return ECursorLoadPriority::Normal;
+}
+
+void UCursoryRegistry::GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const
+{
+	Super::GetAssetRegistryTags(OutTags);
+
+	TArray<FString> TagNames;
+	ECursorLoadPriority LoadPriority = ECursorLoadPriority::Deferred;
+	for (const FCursorInfo& CursorSpec : CursorSpecs)
+	{
+		if (CursorSpec.Identifier.IsValid())
+		{
+			TagNames.Add(CursorSpec.Identifier.ToString());
+			LoadPriority = FMath::Min(LoadPriority, CursorSpec.LoadPriority);
+		}
+	}
+
+	OutTags.Add(FAssetRegistryTag(CursoryRegistry::IdentifiersTag, FString::Join(TagNames, TEXT(",")), FAssetRegistryTag::TT_Hidden));
+	OutTags.Add(FAssetRegistryTag(CursoryRegistry::LoadPriorityTag, StaticEnum<ECursorLoadPriority>()->GetNameStringByValue(static_cast<int64>(LoadPriority)), FAssetRegistryTag::TT_Hidden));
+	OutTags.Add(FAssetRegistryTag(CursoryRegistry::RegisterAtRuntimeTag, bRegisterAtRuntime ? TEXT("True") : TEXT("False"), FAssetRegistryTag::TT_Hidden));
+}
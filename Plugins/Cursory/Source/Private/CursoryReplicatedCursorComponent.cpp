@@ -0,0 +1,235 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryReplicatedCursorComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/Pawn.h"
+#include "Net/UnrealNetwork.h"
+#include "CursoryModule.h"
+#include "CursorySystem.h"
+
+FCursoryQuantizedPosition FCursoryQuantizedPosition::Quantize(const FVector2D& Normalized)
+{
+	FCursoryQuantizedPosition Quantized;
+	Quantized.X = static_cast<uint16>(FMath::RoundToInt(FMath::Clamp(Normalized.X, 0.0, 1.0) * MAX_uint16));
+	Quantized.Y = static_cast<uint16>(FMath::RoundToInt(FMath::Clamp(Normalized.Y, 0.0, 1.0) * MAX_uint16));
+	return Quantized;
+}
+
+FVector2D FCursoryQuantizedPosition::Dequantize() const
+{
+	return FVector2D(static_cast<double>(X) / MAX_uint16, static_cast<double>(Y) / MAX_uint16);
+}
+
+bool FCursoryQuantizedPosition::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << X;
+	Ar << Y;
+	bOutSuccess = true;
+	return true;
+}
+
+UCursoryReplicatedCursorComponent::UCursoryReplicatedCursorComponent()
+	: ReplicatedCursorId(UCursorySystem::InvalidCompactCursorId)
+	, LastSentCursorId(UCursorySystem::InvalidCompactCursorId)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	SetIsReplicatedByDefault(true);
+}
+
+void UCursoryReplicatedCursorComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// The owner already knows where its cursor is.
+	DOREPLIFETIME_CONDITION(UCursoryReplicatedCursorComponent, ReplicatedCursorId, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(UCursoryReplicatedCursorComponent, ReplicatedPosition, COND_SkipOwner);
+}
+
+void UCursoryReplicatedCursorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	APlayerController* Player = GetOwningController();
+	if (Player && Player->IsLocalController())
+	{
+		SendLocalCursor(Player, DeltaTime);
+	}
+
+	else
+	{
+		InterpolateRemoteCursor(DeltaTime);
+	}
+}
+
+APlayerController* UCursoryReplicatedCursorComponent::GetOwningController() const
+{
+	if (const APlayerState* PlayerState = GetOwner<APlayerState>())
+	{
+		return PlayerState->GetPlayerController();
+	}
+
+	if (const APawn* Pawn = GetOwner<APawn>())
+	{
+		return Pawn->GetController<APlayerController>();
+	}
+
+	return nullptr;
+}
+
+void UCursoryReplicatedCursorComponent::SendLocalCursor(APlayerController* Player, float DeltaTime)
+{
+	UCursorySystem& System = ICursoryModule::Get();
+	const int32 UserIndex = UCursorySystem::GetUserIndexForPlayer(Player);
+
+	// Cursor changes are rare, and are sent right away.
+	CursorType = System.GetCurrentCursorType(UserIndex).Get(EMouseCursor::Default);
+	CustomCursorIdentifier = System.GetCurrentCustomCursorIdentifier(UserIndex);
+	const uint16 CursorId = System.GetCompactCursorId(CursorType, CustomCursorIdentifier);
+	if (CursorId != LastSentCursorId)
+	{
+		LastSentCursorId = CursorId;
+		if (GetOwnerRole() == ROLE_Authority)
+		{
+			ReplicatedCursorId = CursorId;
+		}
+
+		else
+		{
+			ServerSetCursorId(CursorId);
+		}
+	}
+
+	float MouseX, MouseY;
+	int32 ViewportX, ViewportY;
+	Player->GetViewportSize(ViewportX, ViewportY);
+	if (!Player->GetMousePosition(MouseX, MouseY) || ViewportX <= 0 || ViewportY <= 0)
+	{
+		return;
+	}
+
+	DisplayedPosition = FVector2D(MouseX / ViewportX, MouseY / ViewportY);
+	bHasCursorState = true;
+
+	// Positions are sent only when they change, and no faster than the send rate.
+	TimeSinceLastSend += DeltaTime;
+	const FCursoryQuantizedPosition Position = FCursoryQuantizedPosition::Quantize(DisplayedPosition);
+	if (Position == LastSentPosition)
+	{
+		// Unreliable updates may be lost, so the position the cursor rests at is sent once more, reliably.
+		if (!bSentSettledPosition && TimeSinceLastSend >= SettleDelay)
+		{
+			bSentSettledPosition = true;
+			if (GetOwnerRole() != ROLE_Authority)
+			{
+				ServerSetSettledPosition(Position);
+			}
+		}
+
+		return;
+	}
+
+	if (TimeSinceLastSend < 1.0f / SendRate)
+	{
+		return;
+	}
+
+	LastSentPosition = Position;
+	TimeSinceLastSend = 0.0f;
+	bSentSettledPosition = false;
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		// Replicated properties always converge to their latest value, so the server needs no settled update.
+		ReplicatedPosition = Position;
+	}
+
+	else
+	{
+		ServerSetPosition(Position);
+	}
+}
+
+void UCursoryReplicatedCursorComponent::InterpolateRemoteCursor(float DeltaTime)
+{
+	if (InterpolationAlpha < 1.0f)
+	{
+		// Updates arrive roughly once per send interval, so blend over that interval.
+		InterpolationAlpha = FMath::Min(InterpolationAlpha + DeltaTime * SendRate, 1.0f);
+		DisplayedPosition = FMath::Lerp(InterpolationStart, InterpolationTarget, InterpolationAlpha);
+	}
+}
+
+void UCursoryReplicatedCursorComponent::ServerSetCursorId_Implementation(uint16 CursorId)
+{
+	ReplicatedCursorId = CursorId;
+
+	// Replication callbacks don't fire on the server, but a listen server's player sees remote cursors too.
+	OnRep_CursorId();
+}
+
+void UCursoryReplicatedCursorComponent::ServerSetPosition_Implementation(FCursoryQuantizedPosition Position)
+{
+	ReplicatedPosition = Position;
+	OnRep_Position();
+}
+
+void UCursoryReplicatedCursorComponent::ServerSetSettledPosition_Implementation(FCursoryQuantizedPosition Position)
+{
+	// Usually a repeat of the last update, which needs no blending.
+	if (Position != ReplicatedPosition)
+	{
+		ServerSetPosition_Implementation(Position);
+	}
+}
+
+void UCursoryReplicatedCursorComponent::OnRep_CursorId()
+{
+	EMouseCursor::Type ResolvedType;
+	if (ICursoryModule::Get().ResolveCompactCursorId(ReplicatedCursorId, ResolvedType, CustomCursorIdentifier))
+	{
+		CursorType = ResolvedType;
+	}
+
+	else
+	{
+		UE_LOG(LogCursory, Warning, TEXT("Received unknown cursor id [%d]. Do all players share the same cursor specs?"), ReplicatedCursorId);
+		CursorType = EMouseCursor::Default;
+		CustomCursorIdentifier = FGameplayTag::EmptyTag;
+	}
+}
+
+void UCursoryReplicatedCursorComponent::OnRep_Position()
+{
+	const FVector2D Position = ReplicatedPosition.Dequantize();
+
+	// Snap to the first position, and blend toward any after.
+	if (!bHasCursorState)
+	{
+		DisplayedPosition = Position;
+		bHasCursorState = true;
+	}
+
+	InterpolationStart = DisplayedPosition;
+	InterpolationTarget = Position;
+	InterpolationAlpha = 0.0f;
+}
+
+TEnumAsByte<EMouseCursor::Type> UCursoryReplicatedCursorComponent::GetCursorType() const
+{
+	return CursorType;
+}
+
+FGameplayTag UCursoryReplicatedCursorComponent::GetCustomCursorIdentifier() const
+{
+	return CustomCursorIdentifier;
+}
+
+FVector2D UCursoryReplicatedCursorComponent::GetCursorPosition() const
+{
+	return DisplayedPosition;
+}
+
+bool UCursoryReplicatedCursorComponent::HasCursorState() const
+{
+	return bHasCursorState;
+}
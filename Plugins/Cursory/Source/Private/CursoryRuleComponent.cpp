@@ -0,0 +1,124 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryRuleComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "CursoryModule.h"
+#include "CursorySystem.h"
+#include "CursoryDebug.h"
+
+UCursoryRuleComponent::UCursoryRuleComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	bAutoActivate = true;
+}
+
+void UCursoryRuleComponent::SetRuleSet(UCursoryRuleSet* InRuleSet)
+{
+	RuleSet = InRuleSet;
+	bEvaluated = false;
+
+	if (IsActive())
+	{
+		UpdateCursor();
+	}
+}
+
+void UCursoryRuleComponent::Activate(bool bReset)
+{
+	Super::Activate(bReset);
+
+	bEvaluated = false;
+}
+
+void UCursoryRuleComponent::Deactivate()
+{
+	ReleaseCursor();
+
+	Super::Deactivate();
+}
+
+void UCursoryRuleComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ReleaseCursor();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UCursoryRuleComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UpdateCursor();
+}
+
+void UCursoryRuleComponent::UpdateCursor()
+{
+	APlayerController* PlayerOwner = Cast<APlayerController>(GetOwner());
+	if (!PlayerOwner || !PlayerOwner->IsLocalController())
+	{
+		return;
+	}
+
+	if (!RuleSet)
+	{
+		ApplyRule(nullptr);
+		return;
+	}
+
+	RuleSet->CompileIfStale();
+
+	// Rules only depend on these inputs, so there is nothing to do until one changes.
+	const FCursoryRuleInputs Inputs = RuleSet->GatherInputs(PlayerOwner, UCursorySystem::GetUserIndexForPlayer(PlayerOwner));
+	if (bEvaluated && Inputs == LastInputs)
+	{
+		return;
+	}
+
+	LastInputs = Inputs;
+	bEvaluated = true;
+	ApplyRule(RuleSet->Evaluate(Inputs));
+}
+
+void UCursoryRuleComponent::ApplyRule(const FCursoryRule* Rule)
+{
+	if (!Rule)
+	{
+		ReleaseCursor();
+		return;
+	}
+
+	if (Handle.IsValid() && AppliedCursor.CursorType == Rule->CursorType && AppliedCursor.CustomCursorIdentifier == Rule->CustomCursorIdentifier)
+	{
+		return;
+	}
+
+	AppliedCursor.CursorType = Rule->CursorType;
+	AppliedCursor.CustomCursorIdentifier = Rule->CustomCursorIdentifier;
+
+	if (Handle.IsValid())
+	{
+		ICursoryModule::Get().ModifyCursorByHandle(Handle, AppliedCursor);
+	}
+
+	else
+	{
+		FCursorStackElement NewCursor(FCursorStackElementHandle::Generate());
+		{
+			NewCursor.CursorType = AppliedCursor.CursorType;
+			NewCursor.CustomCursorIdentifier = AppliedCursor.CustomCursorIdentifier;
+		}
+
+		const int32 UserIndex = UCursorySystem::GetUserIndexForPlayer(Cast<APlayerController>(GetOwner()));
+		Handle = ICursoryModule::Get().PushCursor(NewCursor, UserIndex);
+		CURSORY_DEBUG_OWNER(Handle, FCursoryDebug::FOwner(GetOwner(), TEXT("rule component")));
+	}
+}
+
+void UCursoryRuleComponent::ReleaseCursor()
+{
+	if (Handle.IsValid())
+	{
+		ICursoryModule::Get().RemoveCursorByHandle(Handle);
+		Handle = FCursorStackElementHandle();
+	}
+}
@@ -0,0 +1,274 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryRuleSet.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Application/SlateUser.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "Blueprint/UserWidget.h"
+#include "Slate/SObjectWidget.h"
+#include "GameplayTagAssetInterface.h"
+#include "CursoryModule.h"
+
+namespace CursoryRuleSet
+{
+	/** Predicates are tracked as bits of a 64-bit mask. */
+	constexpr int32 MaxPredicates = 64;
+
+	/** All input modes, as bits. */
+	constexpr uint8 AllInputModes = 0b111;
+
+	uint8 ToInputModeBits(ECursoryInputMode InputMode)
+	{
+		return InputMode == ECursoryInputMode::Any ? AllInputModes : 1 << (static_cast<uint8>(InputMode) - 1);
+	}
+
+	/**
+	 * Infers the input mode from the viewport's mouse capture mode,
+	 * which is what SetInputMode configures.
+	 */
+	ECursoryInputMode GetInputMode(const APlayerController* Player)
+	{
+		const ULocalPlayer* LocalPlayer = Player->GetLocalPlayer();
+		const UGameViewportClient* ViewportClient = LocalPlayer ? LocalPlayer->ViewportClient : nullptr;
+		if (!ViewportClient)
+		{
+			return ECursoryInputMode::GameOnly;
+		}
+
+		switch (ViewportClient->GetMouseCaptureMode())
+		{
+		case EMouseCaptureMode::NoCapture:
+			return ECursoryInputMode::UIOnly;
+		case EMouseCaptureMode::CaptureDuringMouseDown:
+		case EMouseCaptureMode::CaptureDuringRightMouseDown:
+			return ECursoryInputMode::GameAndUI;
+		default:
+			return ECursoryInputMode::GameOnly;
+		}
+	}
+
+	uint8 GetModifiers()
+	{
+		const FModifierKeysState ModifierKeys = FSlateApplication::Get().GetModifierKeys();
+		uint8 Modifiers = 0;
+		Modifiers |= ModifierKeys.IsShiftDown() ? static_cast<uint8>(ECursoryModifierKey::Shift) : 0;
+		Modifiers |= ModifierKeys.IsControlDown() ? static_cast<uint8>(ECursoryModifierKey::Control) : 0;
+		Modifiers |= ModifierKeys.IsAltDown() ? static_cast<uint8>(ECursoryModifierKey::Alt) : 0;
+		Modifiers |= ModifierKeys.IsCommandDown() ? static_cast<uint8>(ECursoryModifierKey::Command) : 0;
+		return Modifiers;
+	}
+
+	void AppendOwnedTags(const UObject* Object, FGameplayTagContainer& OutTags)
+	{
+		if (const IGameplayTagAssetInterface* TagInterface = Cast<IGameplayTagAssetInterface>(Object))
+		{
+			FGameplayTagContainer Tags;
+			TagInterface->GetOwnedGameplayTags(Tags);
+			OutTags.AppendTags(Tags);
+		}
+	}
+
+	/** Gets the user widgets under a user's cursor, innermost last. */
+	void GetHoveredUserWidgets(int32 UserIndex, TArray<const UUserWidget*>& OutWidgets)
+	{
+		TSharedPtr<FSlateUser> SlateUser = FSlateApplication::Get().GetUser(UserIndex);
+		if (!SlateUser.IsValid())
+		{
+			return;
+		}
+
+		const FWeakWidgetPath& WidgetPath = SlateUser->GetLastWidgetsUnderCursor();
+		for (const TWeakPtr<SWidget>& WeakWidget : WidgetPath.Widgets)
+		{
+			TSharedPtr<SWidget> Widget = WeakWidget.Pin();
+			if (Widget.IsValid() && Widget->GetType() == TEXT("SObjectWidget"))
+			{
+				if (const UUserWidget* UserWidget = StaticCastSharedPtr<SObjectWidget>(Widget)->GetWidgetObject())
+				{
+					OutWidgets.Add(UserWidget);
+				}
+			}
+		}
+	}
+}
+
+void UCursoryRuleSet::Compile()
+{
+	CompiledRules.Reset(Rules.Num());
+	Predicates.Reset();
+	bNeedsHoveredActor = false;
+	bNeedsHoveredWidgets = false;
+	bCompiled = true;
+
+	for (int32 RuleIndex = 0; RuleIndex < Rules.Num() && RuleIndex <= MAX_uint16; ++RuleIndex)
+	{
+		const FCursoryRule& Rule = Rules[RuleIndex];
+
+		FCompiledRule& Compiled = CompiledRules.AddDefaulted_GetRef();
+		Compiled.RuleIndex = static_cast<uint16>(RuleIndex);
+		Compiled.RequiredModifiers = static_cast<uint8>(Rule.RequiredModifiers);
+		Compiled.ExcludedModifiers = static_cast<uint8>(Rule.ExcludedModifiers);
+		Compiled.InputModes = CursoryRuleSet::ToInputModeBits(Rule.InputMode);
+
+		TArray<FPredicate, TInlineAllocator<3>> RulePredicates;
+		if (Rule.HoveredActorClass)
+		{
+			RulePredicates.Add({FPredicate::EKind::HoveredActor, Rule.HoveredActorClass.Get()});
+		}
+
+		if (Rule.HoveredWidgetClass)
+		{
+			RulePredicates.Add({FPredicate::EKind::HoveredWidget, Rule.HoveredWidgetClass.Get()});
+		}
+
+		if (!Rule.RequiredTags.IsEmpty() || !Rule.BlockedTags.IsEmpty())
+		{
+			RulePredicates.Add({FPredicate::EKind::Tags, nullptr, Rule.RequiredTags, Rule.BlockedTags});
+		}
+
+		for (const FPredicate& Predicate : RulePredicates)
+		{
+			const uint64 Bit = AddPredicate(Predicate);
+			if (Bit == 0)
+			{
+				// The rule can't be checked, so make sure it never matches.
+				UE_LOG(LogCursory, Warning, TEXT("Cursor rule set [%s] has more than %d distinct conditions. Rule [%d] will be ignored."), *GetName(), CursoryRuleSet::MaxPredicates, RuleIndex);
+				Compiled.InputModes = 0;
+				break;
+			}
+
+			Compiled.RequiredPredicates |= Bit;
+		}
+	}
+}
+
+void UCursoryRuleSet::CompileIfStale()
+{
+	if (!bCompiled || CompiledRules.Num() != FMath::Min(Rules.Num(), MAX_uint16 + 1))
+	{
+		Compile();
+	}
+}
+
+uint64 UCursoryRuleSet::AddPredicate(const FPredicate& Predicate)
+{
+	int32 Index = Predicates.IndexOfByPredicate([&Predicate](const FPredicate& Existing)
+	{
+		return Existing.Kind == Predicate.Kind
+			&& Existing.Class == Predicate.Class
+			&& Existing.RequiredTags == Predicate.RequiredTags
+			&& Existing.BlockedTags == Predicate.BlockedTags;
+	});
+
+	if (Index == INDEX_NONE)
+	{
+		if (Predicates.Num() == CursoryRuleSet::MaxPredicates)
+		{
+			return 0;
+		}
+
+		Index = Predicates.Add(Predicate);
+		bNeedsHoveredActor |= Predicate.Kind == FPredicate::EKind::HoveredActor;
+		bNeedsHoveredWidgets |= Predicate.Kind == FPredicate::EKind::HoveredWidget;
+	}
+
+	return 1ull << Index;
+}
+
+FCursoryRuleInputs UCursoryRuleSet::GatherInputs(const APlayerController* Player, int32 UserIndex) const
+{
+	FCursoryRuleInputs Inputs;
+	if (!Player || !FSlateApplication::IsInitialized())
+	{
+		return Inputs;
+	}
+
+	Inputs.Modifiers = CursoryRuleSet::GetModifiers();
+	Inputs.InputMode = CursoryRuleSet::ToInputModeBits(CursoryRuleSet::GetInputMode(Player));
+
+	if (Predicates.Num() == 0)
+	{
+		return Inputs;
+	}
+
+	// Only gather what the predicates actually need.
+	const AActor* HoveredActor = nullptr;
+	if (bNeedsHoveredActor)
+	{
+		FHitResult HitResult;
+		if (Player->GetHitResultUnderCursor(Player->CurrentClickTraceChannel, false, HitResult))
+		{
+			HoveredActor = HitResult.GetActor();
+		}
+	}
+
+	TArray<const UUserWidget*> HoveredWidgets;
+	if (bNeedsHoveredWidgets)
+	{
+		CursoryRuleSet::GetHoveredUserWidgets(UserIndex, HoveredWidgets);
+	}
+
+	FGameplayTagContainer PlayerTags;
+	CursoryRuleSet::AppendOwnedTags(Player, PlayerTags);
+	CursoryRuleSet::AppendOwnedTags(Player->GetPawn(), PlayerTags);
+	CursoryRuleSet::AppendOwnedTags(Player->PlayerState, PlayerTags);
+
+	for (int32 Index = 0; Index < Predicates.Num(); ++Index)
+	{
+		const FPredicate& Predicate = Predicates[Index];
+
+		bool bHolds = false;
+		switch (Predicate.Kind)
+		{
+		case FPredicate::EKind::HoveredActor:
+			bHolds = HoveredActor && HoveredActor->IsA(Predicate.Class);
+			break;
+		case FPredicate::EKind::HoveredWidget:
+			bHolds = HoveredWidgets.ContainsByPredicate([&Predicate](const UUserWidget* Widget) { return Widget->IsA(Predicate.Class); });
+			break;
+		case FPredicate::EKind::Tags:
+			bHolds = PlayerTags.HasAll(Predicate.RequiredTags) && !PlayerTags.HasAny(Predicate.BlockedTags);
+			break;
+		}
+
+		Inputs.Predicates |= bHolds ? 1ull << Index : 0;
+	}
+
+	return Inputs;
+}
+
+const FCursoryRule* UCursoryRuleSet::Evaluate(const FCursoryRuleInputs& Inputs) const
+{
+	for (const FCompiledRule& Compiled : CompiledRules)
+	{
+		if ((Inputs.Modifiers & Compiled.RequiredModifiers) == Compiled.RequiredModifiers
+			&& (Inputs.Modifiers & Compiled.ExcludedModifiers) == 0
+			&& (Inputs.InputMode & Compiled.InputModes) != 0
+			&& (Inputs.Predicates & Compiled.RequiredPredicates) == Compiled.RequiredPredicates)
+		{
+			return &Rules[Compiled.RuleIndex];
+		}
+	}
+
+	return nullptr;
+}
+
+void UCursoryRuleSet::PostLoad()
+{
+	Super::PostLoad();
+
+	Compile();
+}
+
+#if WITH_EDITOR
+void UCursoryRuleSet::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	Compile();
+}
+#endif
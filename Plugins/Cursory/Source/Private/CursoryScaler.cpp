@@ -0,0 +1,222 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryScaler.h"
+#include "Framework/Application/SlateApplication.h"
+#include "GenericPlatform/ICursor.h"
+#include "Async/Async.h"
+#include "ImageUtils.h"
+#include "CursoryModule.h"
+#include "CursoryDecodeCache.h"
+
+namespace CursoryScaler
+{
+	/** Supported scale range. */
+	constexpr float MinScale = 0.5f;
+	constexpr float MaxScale = 4.0f;
+}
+
+void FCursoryScaler::AddSource(void* BaseHandle, TSharedRef<const FCursoryDecodedCursor> Source)
+{
+	// Platform-native cursors have no pixels to resample.
+	if (BaseHandle && Source->IsDecoded())
+	{
+		Sources.FindOrAdd(BaseHandle).Source = Source;
+	}
+}
+
+TArray<void*> FCursoryScaler::RemoveSource(void* BaseHandle)
+{
+	TArray<void*> ScaledHandles;
+	FScaledSource ScaledSource;
+	if (Sources.RemoveAndCopyValue(BaseHandle, ScaledSource))
+	{
+		// Pending buckets are discarded when they finish, since the source is gone.
+		ScaledSource.Handles.GenerateValueArray(ScaledHandles);
+	}
+
+	return ScaledHandles;
+}
+
+TArray<void*> FCursoryScaler::Reset()
+{
+	TArray<void*> ScaledHandles;
+	for (const TPair<void*, FScaledSource>& Pair : Sources)
+	{
+		for (const TPair<int32, void*>& Handle : Pair.Value.Handles)
+		{
+			ScaledHandles.Add(Handle.Value);
+		}
+	}
+
+	// Pending buckets are discarded when they finish, since the generation has moved on.
+	Sources.Reset();
+	++Generation;
+	return ScaledHandles;
+}
+
+void FCursoryScaler::SetScale(float Scale)
+{
+	const int32 NewBucket = ToBucket(Scale);
+	if (NewBucket != Bucket)
+	{
+		Bucket = NewBucket;
+		GenerateScaledCursors();
+		OnScaledCursorsReady.Broadcast();
+	}
+}
+
+SIZE_T FCursoryScaler::GetResidentBytes() const
+{
+	SIZE_T Bytes = 0;
+	for (const TPair<void*, FScaledSource>& Pair : Sources)
+	{
+		Bytes += Pair.Value.Source->Pixels.GetAllocatedSize();
+	}
+
+	return Bytes;
+}
+
+float FCursoryScaler::GetScale() const
+{
+	return ToScale(Bucket);
+}
+
+void FCursoryScaler::GenerateScaledCursors()
+{
+	if (Bucket == BucketsPerUnit)
+	{
+		return;
+	}
+
+	TArray<TPair<void*, TSharedPtr<const FCursoryDecodedCursor>>> Work;
+	for (TPair<void*, FScaledSource>& Pair : Sources)
+	{
+		FScaledSource& ScaledSource = Pair.Value;
+		if (!ScaledSource.Handles.Contains(Bucket) && !ScaledSource.PendingBuckets.Contains(Bucket))
+		{
+			ScaledSource.PendingBuckets.Add(Bucket);
+			Work.Emplace(Pair.Key, ScaledSource.Source);
+		}
+	}
+
+	if (Work.Num() == 0)
+	{
+		return;
+	}
+
+	TWeakPtr<FCursoryScaler> WeakThis = AsShared();
+	const int32 WorkBucket = Bucket;
+	const int32 WorkGeneration = Generation;
+
+	// Resample in the background, then create handles on the game thread.
+	Async(EAsyncExecution::ThreadPool, [WeakThis, WorkBucket, WorkGeneration, Work = MoveTemp(Work)]()
+	{
+		TArray<TPair<void*, FCursoryDecodedCursor>> Resampled;
+		Resampled.Reserve(Work.Num());
+		for (const TPair<void*, TSharedPtr<const FCursoryDecodedCursor>>& Item : Work)
+		{
+			Resampled.Emplace(Item.Key, Resample(*Item.Value, ToScale(WorkBucket)));
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, WorkBucket, WorkGeneration, Resampled = MoveTemp(Resampled)]() mutable
+		{
+			TSharedPtr<FCursoryScaler> This = WeakThis.Pin();
+			if (This.IsValid() && This->Generation == WorkGeneration)
+			{
+				This->FinishScaledCursors(WorkBucket, MoveTemp(Resampled));
+			}
+		});
+	});
+}
+
+void FCursoryScaler::FinishScaledCursors(int32 InBucket, TArray<TPair<void*, FCursoryDecodedCursor>>&& Resampled)
+{
+	if (!FSlateApplication::IsInitialized())
+	{
+		return;
+	}
+
+	TSharedPtr<ICursor> PlatformCursor = FSlateApplication::Get().GetPlatformCursor();
+	for (const TPair<void*, FCursoryDecodedCursor>& Item : Resampled)
+	{
+		if (FScaledSource* ScaledSource = Sources.Find(Item.Key))
+		{
+			ScaledSource->PendingBuckets.Remove(InBucket);
+			if (void* Handle = FCursoryLoader::CreateHandle(*PlatformCursor, Item.Value))
+			{
+				ScaledSource->Handles.Add(InBucket, Handle);
+			}
+
+			else
+			{
+				UE_LOG(LogCursory, Warning, TEXT("Failed to create hardware cursor [%s] at scale [%.2f]."), *Item.Value.Identifier.ToString(), ToScale(InBucket));
+			}
+		}
+	}
+
+	if (InBucket == Bucket)
+	{
+		OnScaledCursorsReady.Broadcast();
+	}
+}
+
+void* FCursoryScaler::Resolve(void* BaseHandle) const
+{
+	if (Bucket != BucketsPerUnit)
+	{
+		if (const FScaledSource* ScaledSource = Sources.Find(BaseHandle))
+		{
+			if (void* const* Handle = ScaledSource->Handles.Find(Bucket))
+			{
+				return *Handle;
+			}
+		}
+	}
+
+	return BaseHandle;
+}
+
+FCursoryDecodedCursor FCursoryScaler::Resample(const FCursoryDecodedCursor& Source, float Scale)
+{
+	FCursoryDecodedCursor Scaled;
+	Scaled.Identifier = Source.Identifier;
+	Scaled.FullPath = Source.FullPath;
+	Scaled.Hotspot = Source.Hotspot;
+	Scaled.Width = FMath::Max(FMath::RoundToInt(Source.Width * Scale), 1);
+	Scaled.Height = FMath::Max(FMath::RoundToInt(Source.Height * Scale), 1);
+
+	// Resized copies are cached alongside their source.
+	const bool bUseCache = FCursoryDecodeCache::IsEnabled() && !Source.CacheKey.IsEmpty();
+	if (bUseCache)
+	{
+		Scaled.CacheKey = FCursoryDecodeCache::MakeVariantKey(Source.CacheKey, FString::Printf(TEXT("%dx%d"), Scaled.Width, Scaled.Height));
+		if (FCursoryDecodeCache::Get(Scaled.CacheKey, Scaled))
+		{
+			return Scaled;
+		}
+	}
+
+	Scaled.Pixels.SetNumUninitialized(static_cast<int64>(Scaled.Width) * Scaled.Height * sizeof(FColor));
+
+	// Resizing works per channel, so RGBA data can go through as FColor. Alpha has to be kept, or the cursor becomes a solid rectangle.
+	const TArrayView<const FColor> SourceView(reinterpret_cast<const FColor*>(Source.Pixels.GetData()), Source.Width * Source.Height);
+	const TArrayView<FColor> ScaledView(reinterpret_cast<FColor*>(Scaled.Pixels.GetData()), Scaled.Width * Scaled.Height);
+	FImageUtils::ImageResize(Source.Width, Source.Height, SourceView, Scaled.Width, Scaled.Height, ScaledView, false, false);
+
+	if (bUseCache)
+	{
+		FCursoryDecodeCache::Put(Scaled.CacheKey, Scaled);
+	}
+
+	return Scaled;
+}
+
+int32 FCursoryScaler::ToBucket(float Scale)
+{
+	return FMath::RoundToInt(FMath::Clamp(Scale, CursoryScaler::MinScale, CursoryScaler::MaxScale) * BucketsPerUnit);
+}
+
+float FCursoryScaler::ToScale(int32 InBucket)
+{
+	return static_cast<float>(InBucket) / BucketsPerUnit;
+}
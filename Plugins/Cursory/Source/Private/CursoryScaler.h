@@ -0,0 +1,83 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CursoryLoader.h"
+
+/**
+ * Produces resized variants of loaded cursors for a runtime scale multiplier.
+ * Scales are snapped to buckets, and each bucket's handles are cached,
+ * so revisiting a size never resamples again. Resampling runs on the thread pool,
+ * from decoded images kept resident for that purpose.
+ * Platform-native cursor files (.ani, .cur, .tiff) cannot be resampled, and keep their size.
+ */
+class FCursoryScaler : public TSharedFromThis<FCursoryScaler>
+{
+public:
+
+	/** Keeps a decoded cursor resident, so that it can be resampled later. */
+	void AddSource(void* BaseHandle, TSharedRef<const FCursoryDecodedCursor> Source);
+
+	/** Drops a source, and gets the scaled handles generated from it so they can be freed. */
+	TArray<void*> RemoveSource(void* BaseHandle);
+
+	/** Drops all sources (e.g. when cursors are reloaded), and gets the scaled handles generated from them so they can be freed. */
+	TArray<void*> Reset();
+
+	/** Sets the scale multiplier, and generates any missing handles for it. */
+	void SetScale(float Scale);
+
+	/** Gets the memory held by resident decoded images, in bytes. */
+	SIZE_T GetResidentBytes() const;
+
+	/** Gets the scale multiplier, as snapped to its bucket. */
+	float GetScale() const;
+
+	/** Generates handles for the current scale for any sources that lack them. */
+	void GenerateScaledCursors();
+
+	/**
+	 * Gets the handle to mount for a base handle at the current scale.
+	 * Falls back to the base handle while the scaled one is being generated.
+	 */
+	void* Resolve(void* BaseHandle) const;
+
+	/** Fired (on the game thread) when new handles for the current scale become available. */
+	FSimpleMulticastDelegate OnScaledCursorsReady;
+
+	/** Resamples a decoded cursor to the specified scale, keeping its alpha. Safe to call from any thread. */
+	static FCursoryDecodedCursor Resample(const FCursoryDecodedCursor& Source, float Scale);
+
+private:
+
+	/** A resident cursor image, with the handles generated from it. */
+	struct FScaledSource
+	{
+		TSharedPtr<const FCursoryDecodedCursor> Source;
+
+		/** Generated handles, by bucket. */
+		TMap<int32, void*> Handles;
+
+		/** Buckets currently being generated. */
+		TSet<int32> PendingBuckets;
+	};
+
+	/** Creates handles for resampled cursors on the game thread. */
+	void FinishScaledCursors(int32 InBucket, TArray<TPair<void*, FCursoryDecodedCursor>>&& Resampled);
+
+	static int32 ToBucket(float Scale);
+	static float ToScale(int32 InBucket);
+
+	/** Scales are snapped to quarter steps. */
+	static constexpr int32 BucketsPerUnit = 4;
+
+	/** Resident sources, by base (unscaled) handle. */
+	TMap<void*, FScaledSource> Sources;
+
+	/** Current bucket (starts at 1x). */
+	int32 Bucket{BucketsPerUnit};
+
+	/** Incremented on reset, to discard stale background work. */
+	int32 Generation{0};
+};
@@ -12,10 +12,53 @@ class UCursorySettings : public UDeveloperSettings
 
 public:
 
-	/** Custom cursor specs. Will be loaded on Engine startup. */
+	/**
+	 * Custom cursor specs. Will be loaded on Engine startup.
+	 * Large or optional sets of cursors are better kept in cursor registry assets (UCursoryRegistry).
+	 */
 	UPROPERTY(EditAnywhere, config, Category = "Cursors")
 	TSet<FCursorInfo> CustomCursorSpecs;
 
+	/**
+	 * Alternative cursor themes. Each theme overrides a subset of the custom cursors.
+	 * Themes can be pre-warmed in the background and switched at runtime.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Cursors")
+	TArray<FCursorTheme> CursorThemes;
+
+	/**
+	 * If true, decoded cursor images (and their resized copies) are cached in the editor's Derived Data Cache,
+	 * so that unchanged cursor art is not decoded again on later launches and PIE sessions.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Cursors")
+	bool bCacheDecodedCursors{true};
+
+	/**
+	 * If true, builds without the editor cache decoded cursor images in files under Saved/Cursory/DecodedCursors.
+	 * Off by default, as the cache files hold uncompressed pixels on the player's disk.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Cursors")
+	bool bCacheDecodedCursorsOnDisk{false};
+
+	/** Cache files unused for longer than this (in days) are deleted on startup. 0 keeps them regardless of age. */
+	UPROPERTY(EditAnywhere, config, Category = "Cursors", meta=(EditCondition="bCacheDecodedCursorsOnDisk", ClampMin="0"))
+	int32 DecodedCursorCacheMaxAgeDays{30};
+
+	/** Once cache files exceed this size (in megabytes), the least recently used are deleted on startup. 0 is unlimited. */
+	UPROPERTY(EditAnywhere, config, Category = "Cursors", meta=(EditCondition="bCacheDecodedCursorsOnDisk", ClampMin="0"))
+	int32 DecodedCursorCacheMaxSizeMB{32};
+
+	/**
+	 * If true, learns which cursors tend to follow each other, and loads
+	 * deferred cursors in the background once a cursor they often follow is shown.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Cursors")
+	bool bPrefetchCursors{true};
+
+	/** If true, learned cursor transitions are saved between sessions, under Saved/Cursory. */
+	UPROPERTY(EditAnywhere, config, Category = "Cursors", meta=(EditCondition="bPrefetchCursors"))
+	bool bPersistCursorTransitions{true};
+
 	/**
 	 * If true, automatically focuses viewport when directly hovered.
 	 * Prevents reversion to default cursor when viewport loses focus (e.g. on button press).
@@ -25,4 +68,74 @@ public:
 	 */
 	UPROPERTY(EditAnywhere, config, Category = "Focus")
 	bool bAutoFocusViewport{true};
+
+	/**
+	 * If true, the hardware cursor can be driven by a gamepad stick.
+	 * Movement is applied as input events arrive, rather than on game tick.
+	 * Can be toggled at runtime.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Gamepad")
+	bool bEnableGamepadCursor{false};
+
+	/** If true, the right stick drives the cursor. Otherwise, the left stick does. */
+	UPROPERTY(EditAnywhere, config, Category = "Gamepad", meta=(EditCondition="bEnableGamepadCursor"))
+	bool bGamepadCursorUsesRightStick{false};
+
+	/** If true, stick input that drives the cursor is not passed on to the game. */
+	UPROPERTY(EditAnywhere, config, Category = "Gamepad", meta=(EditCondition="bEnableGamepadCursor"))
+	bool bConsumeGamepadCursorInput{false};
+
+	/** Cursor speed (in pixels per second) at full stick deflection. */
+	UPROPERTY(EditAnywhere, config, Category = "Gamepad", meta=(EditCondition="bEnableGamepadCursor", ClampMin="0"))
+	float GamepadCursorSpeed{1200.0f};
+
+	/** Stick deflection below which input is ignored. */
+	UPROPERTY(EditAnywhere, config, Category = "Gamepad", meta=(EditCondition="bEnableGamepadCursor", ClampMin="0", ClampMax="1"))
+	float GamepadCursorDeadZone{0.2f};
+
+	/**
+	 * Response curve exponent applied to stick deflection.
+	 * 1 is linear; higher values give finer control near the center.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Gamepad", meta=(EditCondition="bEnableGamepadCursor", ClampMin="1"))
+	float GamepadCursorResponseExponent{2.0f};
+
+	/** Time (in seconds) for the cursor to accelerate to full speed once the stick is held. */
+	UPROPERTY(EditAnywhere, config, Category = "Gamepad", meta=(EditCondition="bEnableGamepadCursor", ClampMin="0"))
+	float GamepadCursorAccelerationTime{0.25f};
+
+	/** Distance (in pixels) from a target's center within which the cursor is pulled toward it. */
+	UPROPERTY(EditAnywhere, config, Category = "Gamepad", meta=(EditCondition="bEnableGamepadCursor", ClampMin="0"))
+	float GamepadCursorMagnetismRadius{48.0f};
+
+	/** Strength of the pull toward nearby targets (fraction of remaining distance per second). */
+	UPROPERTY(EditAnywhere, config, Category = "Gamepad", meta=(EditCondition="bEnableGamepadCursor", ClampMin="0"))
+	float GamepadCursorMagnetismStrength{6.0f};
+
+	/** Distance (in pixels) from a target's center within which the cursor snaps to it when the stick is released. */
+	UPROPERTY(EditAnywhere, config, Category = "Gamepad", meta=(EditCondition="bEnableGamepadCursor", ClampMin="0"))
+	float GamepadCursorSnapRadius{24.0f};
+
+	/**
+	 * Cursor pushed onto the stack while the gamepad is driving the cursor.
+	 * Removed again once the mouse is moved. Leave empty to keep the current cursor.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Gamepad", meta=(EditCondition="bEnableGamepadCursor"))
+	FGameplayTag GamepadCursorIdentifier;
+
+	/**
+	 * If true, records a heatmap of where the cursor moves and clicks, per cursor,
+	 * saved under Saved/Cursory/Heatmaps. Cheap enough to leave on in playtest builds.
+	 * Can be toggled at runtime.
+	 */
+	UPROPERTY(EditAnywhere, config, Category = "Heatmap")
+	bool bCaptureHeatmap{false};
+
+	/** Heatmap grid size, in cells, spread over the game viewport. */
+	UPROPERTY(EditAnywhere, config, Category = "Heatmap", meta=(EditCondition="bCaptureHeatmap", ClampMin="1", ClampMax="1024"))
+	FIntPoint HeatmapResolution{64, 36};
+
+	/** Time (in seconds) between heatmap saves. */
+	UPROPERTY(EditAnywhere, config, Category = "Heatmap", meta=(EditCondition="bCaptureHeatmap", ClampMin="1"))
+	float HeatmapFlushInterval{30.0f};
 };
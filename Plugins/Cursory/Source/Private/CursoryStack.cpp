@@ -0,0 +1,55 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "CursoryStack.h"
+
+void FCursoryStack::Push(FCursorStackElementHandle Handle, EMouseCursor::Type CursorType, const FGameplayTag& CustomCursorIdentifier)
+{
+	FCursoryStackEntry& Entry = Entries.AddUninitialized_GetRef();
+	Entry.Handle = Handle;
+	Entry.CursorType = CursorType;
+	Entry.CustomCursorIdentifier = CustomCursorIdentifier;
+}
+
+void FCursoryStack::Pop()
+{
+	Entries.Pop(false);
+}
+
+bool FCursoryStack::Remove(FCursorStackElementHandle Handle)
+{
+	const FCursoryStackEntry* Entry = Find(Handle);
+	if (!Entry)
+	{
+		return false;
+	}
+
+	Entries.RemoveAt(Entry - Entries.GetData(), 1, false);
+	return true;
+}
+
+void FCursoryStack::Truncate(int32 NewNum)
+{
+	if (NewNum < Entries.Num())
+	{
+		Entries.SetNum(NewNum, false);
+	}
+}
+
+FCursoryStackEntry* FCursoryStack::Find(FCursorStackElementHandle Handle)
+{
+	// Stacks are shallow, and the most recent pushes are the likeliest to be modified or removed.
+	for (int32 Index = Entries.Num() - 1; Index >= 0; --Index)
+	{
+		if (Entries[Index].Handle == Handle)
+		{
+			return &Entries[Index];
+		}
+	}
+
+	return nullptr;
+}
+
+const FCursoryStackEntry* FCursoryStack::Find(FCursorStackElementHandle Handle) const
+{
+	return const_cast<FCursoryStack*>(this)->Find(Handle);
+}
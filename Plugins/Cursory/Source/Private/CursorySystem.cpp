@@ -6,23 +6,40 @@
 #include "Misc/Paths.h"
 #include "CursoryModule.h"
 #include "CursorySettings.h"
+#include "CursoryGamepadCursor.h"
+#include "CursoryMouseSampler.h"
+#include "CursoryHeatmap.h"
+#include "CursoryPrefetcher.h"
+#include "CursoryLoader.h"
+#include "CursoryDecodeCache.h"
+#include "CursoryRegistry.h"
+#include "CursoryScaler.h"
+#include "CursoryLatencyTracker.h"
+#include "CursoryDebug.h"
 #include "Misc/CoreDelegates.h"
-#include "IImageWrapperModule.h"
-#include "HAL/FileManager.h"
-#include "IImageWrapper.h"
-#include "Misc/FileHelper.h"
-#include "HAL/PlatformApplicationMisc.h"
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
 #include "GameFramework/GameModeBase.h"
 #include "Widgets/SWidget.h"
-#include "Blueprint/WidgetBlueprintLibrary.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/PlayerController.h"
 #include "Widgets/SViewport.h"
+#include "Widgets/SWindow.h"
+#include "Framework/Application/SlateUser.h"
+#include "Engine/LocalPlayer.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/AssetRegistryModule.h"
 
 #if WITH_EDITOR
 #include "Editor.h"
 #endif
 
+DECLARE_STATS_GROUP(TEXT("Cursory"), STATGROUP_Cursory, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Loaded Cursors"), STAT_CursoryLoadedCursors, STATGROUP_Cursory);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Unique Cursor Handles"), STAT_CursoryUniqueHandles, STATGROUP_Cursory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Platform Cursor Mounts"), STAT_CursoryPlatformMounts, STATGROUP_Cursory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skipped Cursor Mounts"), STAT_CursorySkippedMounts, STATGROUP_Cursory);
+
 #define LOCTEXT_NAMESPACE "CursoryGlobals"
 
 void UCursorySystem::Init()
@@ -33,17 +50,41 @@ void UCursorySystem::Init()
 		UE_LOG(LogCursory, Error, TEXT("Tried to initialize CursoryGlobals after they were already initialized. Are you calling Init() twice?"));
 	}
 
+	GamepadCursor = MakeShared<FCursoryGamepadCursor>();
+	Scaler = MakeShared<FCursoryScaler>();
+	Scaler->OnScaledCursorsReady.AddUObject(this, &UCursorySystem::RemountCurrentCursor);
+
 	// Push base cursor and load custom cursors once on Engine init.
 	FCoreDelegates::OnPostEngineInit.AddWeakLambda(this, [this]()
 	{
+		BuildCompactCursorIds();
+
+		if (FCursoryDecodeCache::IsEnabled())
+		{
+			Async(EAsyncExecution::ThreadPool, &FCursoryDecodeCache::Prune);
+		}
+
+		if (GetDefault<UCursorySettings>()->bPrefetchCursors && GetDefault<UCursorySettings>()->bPersistCursorTransitions)
+		{
+			FCursoryPrefetcher::Get().LoadTransitions();
+		}
+
 		if (FSlateApplication::IsInitialized())
 		{
 			LoadCustomCursors();
-			ClearCursorStack();
+			ClearCursorStacks();
 			MonitorViewportStatus();
+			SetGamepadCursorEnabled(GetDefault<UCursorySettings>()->bEnableGamepadCursor);
+			SetHeatmapCaptureEnabled(GetDefault<UCursorySettings>()->bCaptureHeatmap);
 		}
 	});
 
+	// Stop listening to input before Slate shuts down, even if readers are still held.
+	FCoreDelegates::OnEnginePreExit.AddWeakLambda(this, [this]()
+	{
+		ReleaseMouseSampler(true);
+	});
+
 #if WITH_EDITOR
 
 	// If in Editor, load cursors every time PIE starts.
@@ -55,335 +96,1658 @@ void UCursorySystem::Init()
 	// If in Editor, reset base cursor every time PIE ends.
 	FEditorDelegates::EndPIE.AddWeakLambda(this, [this](const bool bIsSimulating)
 	{
-		ClearCursorStack();
+		ClearCursorStacks();
 	});
 
 #endif
 }
 
-struct FPNGConverter
+TOptional<EMouseCursor::Type> UCursorySystem::GetCurrentCursorType(int32 UserIndex /* = 0 */) const
+{
+	if (const FCursoryUserState* UserState = FindUserState(UserIndex))
+	{
+		return UserState->CachedCursorType;
+	}
+
+	return EMouseCursor::Default;
+}
+
+FGameplayTag UCursorySystem::GetCurrentCustomCursorIdentifier(int32 UserIndex /* = 0 */) const
 {
-	/** 
-	 * Describes PNG file data that can be used to
-	 * create a cursor. 
-	 */
-	struct FPngFileData
+	if (const FCursoryUserState* UserState = FindUserState(UserIndex))
 	{
-		FString FileName;
-		double ScaleFactor;
-		TArray<uint8> FileData;
+		return UserState->CachedCustomCursorIdentifier;
+	}
+
+	return FGameplayTag::EmptyTag;
+}
 
-		FPngFileData()
-			: ScaleFactor(1.0)
+void UCursorySystem::LoadCustomCursors()
+{
+	// Free the previous load's handles (e.g. on every PIE start), unmounting first in case one of them is showing.
+	if (FSlateApplication::IsInitialized() && HandleReferences.Num() > 0)
+	{
+		if (TSharedPtr<ICursor> PlatformCursor = FSlateApplication::Get().GetPlatformCursor())
 		{
+			PlatformCursor->SetTypeShape(EMouseCursor::Custom, nullptr);
 		}
-	};
+	}
+
+	for (void* ScaledHandle : Scaler->Reset())
+	{
+		FCursoryLoader::DestroyHandle(ScaledHandle);
+	}
+
+	for (const TPair<void*, int32>& Handle : HandleReferences)
+	{
+		FCursoryLoader::DestroyHandle(Handle.Key);
+	}
 
-	static void* LoadCursorsFromPngs(ICursor& PlatformCursor, const FString& InPathToCursorWithoutExtension, FVector2D InHotSpot)
+	// Handles are about to change, so any outstanding loads are stale.
+	LoadedCustomCursors.Reset();
+	WarmingThemes.Reset();
+	LoadStatuses.Reset();
+	DeferredSpecs.Reset();
+	PendingLoads = 0;
+	HandlesByContent.Reset();
+	LoadedCursorCount = 0;
+	UniqueHandleCount = 0;
+	HandleReferences.Reset();
+	RegistryCursors.Reset();
+	UnloadedRegistries.Reset();
+	ForgetMountedCursor();
+	++LoadGeneration;
+	BuildCompactCursorIds();
+
+	// Specs in the project settings come first, so they take precedence over registries.
+	LoadedCustomCursors.Add(NAME_None);
+	AddBaseCursorSpecs(GetDefault<UCursorySettings>()->CustomCursorSpecs.Array());
+	ResolveCursorRegistries();
+
+	// Cursor sets registered at runtime are kept across reloads.
+	for (const TPair<FName, FCursorSet>& CursorSet : CursorSets)
+	{
+		LoadCursorSet(CursorSet.Key);
+	}
+
+	// Restore the active theme on top of the fresh base cursors.
+	const FName Theme = ActiveTheme.IsNone() ? PendingTheme : ActiveTheme;
+	ActiveTheme = NAME_None;
+	PendingTheme = NAME_None;
+	if (!Theme.IsNone())
+	{
+		SetTheme(Theme);
+	}
+}
+
+void UCursorySystem::AddBaseCursorSpecs(TArrayView<const FCursorInfo> CustomCursorSpecs)
+{
+	TMap<FGameplayTag, void*>& BaseCursors = LoadedCustomCursors.FindOrAdd(NAME_None);
+	TSharedPtr<ICursor> PlatformCursor = FSlateApplication::Get().GetPlatformCursor();
+	const float PlatformScaleFactor = FCursoryLoader::GetPlatformScaleFactor();
+	TArray<FCursorInfo> NormalSpecs;
+	TMap<FString, FString> SeenSources;
+
+	// Iterate through specs and load critical cursor handles right away.
+	for (const FCursorInfo& CursorSpec : CustomCursorSpecs)
 	{
-		if (!PlatformCursor.IsCreateCursorFromRGBABufferSupported())
+		if (CursorSpec.LoadPriority == ECursorLoadPriority::Normal)
+		{
+			NormalSpecs.Add(CursorSpec);
+			continue;
+		}
+
+		if (CursorSpec.LoadPriority == ECursorLoadPriority::Deferred)
+		{
+			DeferredSpecs.Add(CursorSpec);
+			LoadStatuses.Add(CursorSpec.Identifier, ECursorLoadStatus::Unloaded);
+			continue;
+		}
+
+		void* HardwareCursor = FindOrCreateCursorHandle(*PlatformCursor, FCursoryLoader::Decode(CursorSpec, PlatformScaleFactor, &SeenSources));
+		if (!HardwareCursor)
 		{
-			return nullptr;
+			UE_LOG(LogCursory, Warning, TEXT("Failed to load hardware cursor [%s] located at [%s]."), *CursorSpec.Identifier.ToString(), *CursorSpec.Path);
+			LoadStatuses.Add(CursorSpec.Identifier, ECursorLoadStatus::Failed);
+			continue;
 		}
 
-		TArray<TSharedPtr<FPngFileData>> CursorPngFiles;
-		if (!LoadAvailableCursorPngs(CursorPngFiles, InPathToCursorWithoutExtension))
+		// Save cursor handle.
+		BaseCursors.Add(CursorSpec.Identifier, HardwareCursor);
+		LoadStatuses.Add(CursorSpec.Identifier, ECursorLoadStatus::Loaded);
+	}
+
+	ReportCursorSharing();
+
+	Scaler->GenerateScaledCursors();
+
+	// Normal cursors follow in the background; deferred ones wait for first use or idle time.
+	LoadBaseCursorsAsync(MoveTemp(NormalSpecs));
+	ScheduleIdleLoads();
+}
+
+void UCursorySystem::ResolveCursorRegistries()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		// Wait for the initial scan (i.e. in the editor), so that no registry is missed.
+		if (!AssetRegistryScanHandle.IsValid())
 		{
-			return nullptr;
+			AssetRegistryScanHandle = AssetRegistry.OnFilesLoaded().AddUObject(this, &UCursorySystem::ResolveCursorRegistries);
 		}
 
-		check(CursorPngFiles.Num() > 0);
-		TSharedPtr<FPngFileData> NearestCursor = CursorPngFiles[0];
-		float PlatformScaleFactor = FPlatformApplicationMisc::GetDPIScaleFactorAtPoint(0, 0);
-		for (TSharedPtr<FPngFileData>& FileData : CursorPngFiles)
+		return;
+	}
+
+	if (AssetRegistryScanHandle.IsValid())
+	{
+		AssetRegistry.OnFilesLoaded().Remove(AssetRegistryScanHandle);
+		AssetRegistryScanHandle.Reset();
+		BuildCompactCursorIds();
+	}
+
+	TArray<FAssetData> Registries;
+	UCursoryRegistry::FindRegistries(Registries);
+
+	for (const FAssetData& Registry : Registries)
+	{
+		// Claim identifiers up front, so that deferred cursors are known before their registry is loaded.
+		for (const FGameplayTag& Identifier : UCursoryRegistry::GetIdentifiers(Registry))
 		{
-			const float NewDelta = FMath::Abs(FileData->ScaleFactor - PlatformScaleFactor);
-			if (NewDelta < FMath::Abs(NearestCursor->ScaleFactor - PlatformScaleFactor))
+			if (LoadStatuses.Contains(Identifier) || RegistryCursors.Contains(Identifier))
 			{
-				NearestCursor = FileData;
+				UE_LOG(LogCursory, Warning, TEXT("Custom cursor [%s] in registry [%s] is already defined elsewhere, and will be ignored."), *Identifier.ToString(), *Registry.ObjectPath.ToString());
+				continue;
 			}
-		}
 
-		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
-		TSharedPtr<IImageWrapper>PngImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+			RegistryCursors.Add(Identifier, FSoftObjectPath(Registry.ObjectPath));
+			LoadStatuses.Add(Identifier, ECursorLoadStatus::Unloaded);
+		}
 
-		if (PngImageWrapper.IsValid() && PngImageWrapper->SetCompressed(NearestCursor->FileData.GetData(), NearestCursor->FileData.Num()))
+		switch (UCursoryRegistry::GetLoadPriority(Registry))
 		{
-			TArray64<uint8> RawImageData;
-			if (PngImageWrapper->GetRaw(ERGBFormat::RGBA, 8, RawImageData))
+		case ECursorLoadPriority::Critical:
+			if (const UCursoryRegistry* CursorRegistry = Cast<UCursoryRegistry>(Registry.GetAsset()))
 			{
-				const int32 Width = PngImageWrapper->GetWidth();
-				const int32 Height = PngImageWrapper->GetHeight();
+				AddRegistryCursorSpecs(*CursorRegistry);
+			}
 
-				return PlatformCursor.CreateCursorFromRGBABuffer((FColor*)RawImageData.GetData(), Width, Height, InHotSpot);
+			else
+			{
+				UE_LOG(LogCursory, Warning, TEXT("Failed to load cursor registry [%s]."), *Registry.ObjectPath.ToString());
 			}
-		}
+			break;
 
-		return nullptr;
+		case ECursorLoadPriority::Normal:
+			LoadCursorRegistry(FSoftObjectPath(Registry.ObjectPath), FGameplayTag::EmptyTag);
+			break;
+
+		case ECursorLoadPriority::Deferred:
+			UnloadedRegistries.Add(FSoftObjectPath(Registry.ObjectPath));
+			break;
+		}
 	}
 
-	static bool LoadAvailableCursorPngs(TArray<TSharedPtr<FPngFileData>>& Results, const FString& InPathToCursorWithoutExtension)
+	ScheduleIdleLoads();
+}
+
+void UCursorySystem::AddRegistryCursorSpecs(const UCursoryRegistry& Registry)
+{
+	const FSoftObjectPath RegistryPath(&Registry);
+	TArray<FCursorInfo> Specs;
+	for (const FCursorInfo& CursorSpec : Registry.CursorSpecs)
 	{
-		FString CursorsWithSizeSearch = FPaths::GetCleanFilename(InPathToCursorWithoutExtension) + TEXT("*.png");
+		// Skip identifiers claimed elsewhere (e.g. in the project settings).
+		const FSoftObjectPath* Owner = RegistryCursors.Find(CursorSpec.Identifier);
+		if (Owner ? *Owner == RegistryPath : !LoadStatuses.Contains(CursorSpec.Identifier))
+		{
+			Specs.Add(CursorSpec);
+		}
+	}
 
-		TArray<FString> PngCursorFiles;
-		IFileManager::Get().FindFilesRecursive(PngCursorFiles, *FPaths::GetPath(InPathToCursorWithoutExtension), *CursorsWithSizeSearch, true, false, false);
+	AddBaseCursorSpecs(Specs);
+}
 
-		bool bFoundCursor = false;
+void UCursorySystem::LoadCursorRegistry(const FSoftObjectPath& RegistryPath, FGameplayTag RequestedIdentifier)
+{
+	UnloadedRegistries.Remove(RegistryPath);
 
-		for (const FString& FullCursorPath : PngCursorFiles)
+	++PendingLoads;
+	const int32 Generation = LoadGeneration;
+	LoadPackageAsync(RegistryPath.GetLongPackageName(), FLoadPackageAsyncDelegate::CreateWeakLambda(this, [this, Generation, RegistryPath, RequestedIdentifier](const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result)
+	{
+		if (LoadGeneration != Generation)
 		{
-			FString CursorFile = FPaths::GetBaseFilename(FullCursorPath);
+			return;
+		}
 
-			FString Dummy;
-			FString ScaleFactorSection;
-			FString ScaleFactor;
+		--PendingLoads;
+		if (!FSlateApplication::IsInitialized())
+		{
+			return;
+		}
 
-			if (CursorFile.Split(TEXT("@"), &Dummy, &ScaleFactorSection, ESearchCase::IgnoreCase, ESearchDir::FromEnd))
+		const UCursoryRegistry* Registry = Cast<UCursoryRegistry>(RegistryPath.ResolveObject());
+		if (!Registry)
+		{
+			UE_LOG(LogCursory, Warning, TEXT("Failed to load cursor registry [%s]."), *RegistryPath.ToString());
+			for (const TPair<FGameplayTag, FSoftObjectPath>& RegistryCursor : RegistryCursors)
 			{
-				if (ScaleFactorSection.Split(TEXT("x"), &ScaleFactor, &Dummy) == false)
+				if (RegistryCursor.Value == RegistryPath)
 				{
-					ScaleFactor = ScaleFactorSection;
+					LoadStatuses.Add(RegistryCursor.Key, ECursorLoadStatus::Failed);
 				}
 			}
-			else
-			{
-				ScaleFactor = TEXT("1");
-			}
 
-			if (FCString::IsNumeric(*ScaleFactor) == false)
+			return;
+		}
+
+		AddRegistryCursorSpecs(*Registry);
+
+		// The registry was loaded for a deferred cursor, which is still wanted.
+		if (RequestedIdentifier.IsValid())
+		{
+			RequestCursorLoad(RequestedIdentifier);
+		}
+	}));
+}
+
+void UCursorySystem::ScheduleIdleLoads()
+{
+	if ((DeferredSpecs.Num() > 0 || UnloadedRegistries.Num() > 0) && !IdleLoadHandle.IsValid())
+	{
+		IdleLoadHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UCursorySystem::LoadDeferredCursorsWhenIdle));
+	}
+}
+
+void UCursorySystem::LoadCursorsAsync(TArray<FCursorInfo>&& Specs, TUniqueFunction<void(TMap<FGameplayTag, void*>&&)>&& OnLoaded)
+{
+	const float PlatformScaleFactor = FCursoryLoader::GetPlatformScaleFactor();
+	const int32 Generation = LoadGeneration;
+	TWeakObjectPtr<UCursorySystem> WeakThis(this);
+
+	// Decode in the background, then create handles on the game thread.
+	Async(EAsyncExecution::ThreadPool, [WeakThis, Generation, Specs = MoveTemp(Specs), PlatformScaleFactor, OnLoaded = MoveTemp(OnLoaded)]() mutable
+	{
+		TArray<FCursoryDecodedCursor> DecodedCursors;
+		TMap<FString, FString> SeenSources;
+		for (const FCursorInfo& Spec : Specs)
+		{
+			DecodedCursors.Add(FCursoryLoader::Decode(Spec, PlatformScaleFactor, &SeenSources));
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Generation, DecodedCursors = MoveTemp(DecodedCursors), OnLoaded = MoveTemp(OnLoaded)]() mutable
+		{
+			UCursorySystem* This = WeakThis.Get();
+			if (!This || This->LoadGeneration != Generation || !FSlateApplication::IsInitialized())
 			{
-				UE_LOG(LogInit, Error, TEXT("Failed to load cursor '%s', non-numeric characters in the scale factor."), *FullCursorPath);
-				continue;
+				return;
 			}
 
-			TSharedPtr<FPngFileData> PngFileData = MakeShared<FPngFileData>();
-			PngFileData->FileName = FullCursorPath;
-			PngFileData->ScaleFactor = FCString::Atof(*ScaleFactor);
-
-			if (FFileHelper::LoadFileToArray(PngFileData->FileData, *FullCursorPath, FILEREAD_Silent))
+			TSharedPtr<ICursor> PlatformCursor = FSlateApplication::Get().GetPlatformCursor();
+			TMap<FGameplayTag, void*> Cursors;
+			for (FCursoryDecodedCursor& Decoded : DecodedCursors)
 			{
-				UE_LOG(LogInit, Log, TEXT("Loading Cursor '%s'."), *FullCursorPath);
+				const FGameplayTag Identifier = Decoded.Identifier;
+				const FString FullPath = Decoded.FullPath;
+				if (void* HardwareCursor = This->FindOrCreateCursorHandle(*PlatformCursor, MoveTemp(Decoded)))
+				{
+					Cursors.Add(Identifier, HardwareCursor);
+				}
+
+				else
+				{
+					UE_LOG(LogCursory, Warning, TEXT("Failed to load hardware cursor [%s] located at [%s]."), *Identifier.ToString(), *FullPath);
+				}
 			}
 
-			Results.Add(PngFileData);
+			This->Scaler->GenerateScaledCursors();
+			This->ReportCursorSharing();
+			OnLoaded(MoveTemp(Cursors));
+		});
+	});
+}
 
-			bFoundCursor = true;
+void* UCursorySystem::FindOrCreateCursorHandle(ICursor& PlatformCursor, FCursoryDecodedCursor&& Decoded)
+{
+	if (!Decoded.ContentKey.IsEmpty())
+	{
+		if (void* const* ExistingHandle = HandlesByContent.Find(Decoded.ContentKey))
+		{
+#if CURSORY_DEBUG
+			FCursoryDebug::Get().RecordLoad(Decoded.Identifier, Decoded.DecodeSeconds, 0.0, true);
+#endif
+			++LoadedCursorCount;
+			++HandleReferences.FindOrAdd(*ExistingHandle);
+			return *ExistingHandle;
 		}
+	}
+
+#if CURSORY_DEBUG
+	const double CreateStartTime = FPlatformTime::Seconds();
+#endif
+
+	void* HardwareCursor = FCursoryLoader::CreateHandle(PlatformCursor, Decoded);
 
-		Results.StableSort([](const TSharedPtr<FPngFileData>& InFirst, const TSharedPtr<FPngFileData>& InSecond) -> bool
+#if CURSORY_DEBUG
+	FCursoryDebug::Get().RecordLoad(Decoded.Identifier, Decoded.DecodeSeconds, FPlatformTime::Seconds() - CreateStartTime, false);
+#endif
+
+	if (HardwareCursor)
+	{
+		++LoadedCursorCount;
+		++UniqueHandleCount;
+		++HandleReferences.FindOrAdd(HardwareCursor);
+		if (!Decoded.ContentKey.IsEmpty())
 		{
-			return InFirst->ScaleFactor < InSecond->ScaleFactor;
-		});
+			HandlesByContent.Add(Decoded.ContentKey, HardwareCursor);
+		}
 
-		return bFoundCursor;
+		// Keep the image around for resizing.
+		Scaler->AddSource(HardwareCursor, MakeShared<FCursoryDecodedCursor>(MoveTemp(Decoded)));
 	}
-};
 
-TOptional<EMouseCursor::Type> UCursorySystem::GetCurrentCursorType() const
-{
-	return CachedCursorType.GetValue();
+	return HardwareCursor;
 }
 
-FGameplayTag UCursorySystem::GetCurrentCustomCursorIdentifier() const
+void UCursorySystem::ReleaseCursorHandle(void* Handle)
 {
-	return CachedCustomCursorIdentifier;
-}
+	int32* References = HandleReferences.Find(Handle);
+	if (!References)
+	{
+		return;
+	}
 
-void UCursorySystem::LoadCustomCursors()
-{
-	LoadedCustomCursors.Reset();
+	--LoadedCursorCount;
+	if (--(*References) > 0)
+	{
+		return;
+	}
 
-	TSharedPtr<ICursor> PlatformCursor = FSlateApplication::Get().GetPlatformCursor();
-	const TSet<FCursorInfo> CustomCursorSpecs = GetDefault<UCursorySettings>()->CustomCursorSpecs;
+	HandleReferences.Remove(Handle);
+	--UniqueHandleCount;
 
-	// Iterate through specs and load cursor handles.
-	for (const FCursorInfo& CursorSpec : CustomCursorSpecs)
+	for (auto It = HandlesByContent.CreateIterator(); It; ++It)
 	{
-		// Validate hot spot.
-		FVector2D Hotspot = CursorSpec.Hotspot;
-		ensure(Hotspot.X >= 0.0f && Hotspot.X <= 1.0f);
-		ensure(Hotspot.Y >= 0.0f && Hotspot.Y <= 1.0f);
-		Hotspot.X = FMath::Clamp(Hotspot.X, 0.0f, 1.0f);
-		Hotspot.Y = FMath::Clamp(Hotspot.Y, 0.0f, 1.0f);
-
-		// Create the cursor on the platform.
-		FString CursorFullPath = FPaths::ProjectContentDir() / CursorSpec.Path;
-		void* HardwareCursor = PlatformCursor->CreateCursorFromFile(CursorFullPath, Hotspot);
-		if (!HardwareCursor)
+		if (It.Value() == Handle)
 		{
-			// Fallback to PNG loading.
-			HardwareCursor = FPNGConverter::LoadCursorsFromPngs(*PlatformCursor, CursorFullPath, Hotspot);
-			if (!HardwareCursor)
-			{
-				UE_LOG(LogCursory, Warning, TEXT("Failed to load hardware cursor [%s] located at [%s]."), *CursorSpec.Identifier.ToString(), *CursorFullPath);
-				continue;
-			}
+			It.RemoveCurrent();
 		}
+	}
 
-		// Save cursor handle.
-		LoadedCustomCursors.Add(CursorSpec.Identifier, HardwareCursor);
+	for (void* ScaledHandle : Scaler->RemoveSource(Handle))
+	{
+		FCursoryLoader::DestroyHandle(ScaledHandle);
 	}
-}
 
-int32 UCursorySystem::GetCustomCursorCount() const
-{
-	return LoadedCustomCursors.Num();
+	// The platform may hand the same value out again for a new cursor.
+	FCursoryLoader::DestroyHandle(Handle);
+	ForgetMountedCursor();
 }
 
-FGameplayTagContainer UCursorySystem::GetCustomCursorOptions() const
+void UCursorySystem::ReportCursorSharing() const
 {
-	FGameplayTagContainer Options;
-	for (const auto& LoadedCursorPair : LoadedCustomCursors) 
+	SET_DWORD_STAT(STAT_CursoryLoadedCursors, LoadedCursorCount);
+	SET_DWORD_STAT(STAT_CursoryUniqueHandles, UniqueHandleCount);
+
+	if (UniqueHandleCount > 0)
 	{
-		Options.AddTag(LoadedCursorPair.Key);
+		UE_LOG(LogCursory, Log, TEXT("%d cursors share %d platform handles (%.2fx deduplication)."), LoadedCursorCount, UniqueHandleCount, static_cast<float>(LoadedCursorCount) / UniqueHandleCount);
 	}
-	return Options;
 }
 
-void UCursorySystem::MountCustomCursor(FGameplayTag& Identifier, bool bWidget /* = false */)
+void UCursorySystem::LoadBaseCursorsAsync(TArray<FCursorInfo>&& Specs)
 {
-	if (auto Cursor = LoadedCustomCursors.Find(Identifier))
+	if (Specs.Num() == 0)
 	{
-		FSlateApplication::Get().GetPlatformCursor()->SetTypeShape(EMouseCursor::Custom, *Cursor);
+		return;
 	}
 
-	else
+	TArray<FGameplayTag> Identifiers;
+	for (const FCursorInfo& Spec : Specs)
 	{
-		UE_LOG(LogCursory, Warning, TEXT("Tried to mount custom cursor [%s], but no such cursor has been loaded."), *Identifier.ToString());
+		Identifiers.Add(Spec.Identifier);
+		LoadStatuses.Add(Spec.Identifier, ECursorLoadStatus::Loading);
 	}
+
+	++PendingLoads;
+	LoadCursorsAsync(MoveTemp(Specs), [this, Identifiers = MoveTemp(Identifiers)](TMap<FGameplayTag, void*>&& Cursors)
+	{
+		--PendingLoads;
+
+		TMap<FGameplayTag, void*>& BaseCursors = LoadedCustomCursors.FindOrAdd(NAME_None);
+		for (const FGameplayTag& Identifier : Identifiers)
+		{
+			void* const* HardwareCursor = Cursors.Find(Identifier);
+			LoadStatuses.Add(Identifier, HardwareCursor ? ECursorLoadStatus::Loaded : ECursorLoadStatus::Failed);
+			if (HardwareCursor)
+			{
+				BaseCursors.Add(Identifier, *HardwareCursor);
+			}
+		}
+
+		// The current cursor may have been waiting on one of these.
+		if (Cursors.Contains(GetActiveCustomCursorIdentifier()))
+		{
+			RemountCurrentCursor();
+		}
+	});
 }
 
-void UCursorySystem::PushBaseCursor()
+bool UCursorySystem::LoadDeferredCursorsWhenIdle(float DeltaTime)
 {
-	FCursorStackElement BaseCursor(FCursorStackElementHandle::Generate());
+	// Trickle deferred cursors in one at a time, once nothing else is loading.
+	if (PendingLoads == 0 && DeferredSpecs.Num() > 0)
 	{
-		BaseCursor.CursorType = EMouseCursor::Default;
-		BaseCursor.CustomCursorIdentifier = FGameplayTag::EmptyTag;
+		RequestCursorLoad(DeferredSpecs[0].Identifier);
 	}
-	CursorStack.Push(BaseCursor);
-	EvaluateCursorStack();
-}
 
-void UCursorySystem::ModifyBaseCursor(const FCursorStackElement& Cursor, bool bIgnoreType /*= false*/, bool bIgnoreCustom /*= false*/)
-{
-	if (!bIgnoreType)
+	// Then resolve the registries that only hold deferred cursors.
+	else if (PendingLoads == 0 && UnloadedRegistries.Num() > 0)
 	{
-		CursorStack[0].CursorType = Cursor.CursorType;
+		LoadCursorRegistry(*UnloadedRegistries.CreateConstIterator(), FGameplayTag::EmptyTag);
 	}
 
-	if (!bIgnoreCustom)
+	if (DeferredSpecs.Num() == 0 && UnloadedRegistries.Num() == 0)
 	{
-		CursorStack[0].CustomCursorIdentifier = Cursor.CustomCursorIdentifier;
+		IdleLoadHandle.Reset();
+		return false;
 	}
 
-	EvaluateCursorStack();
+	return true;
 }
 
-FCursorStackElementHandle UCursorySystem::PushCursor(FCursorStackElement Cursor)
+void UCursorySystem::RequestCursorLoad(FGameplayTag Identifier)
 {
-	if (Cursor.GetHandle().IsValid())
+	const int32 SpecIndex = DeferredSpecs.IndexOfByPredicate([&Identifier](const FCursorInfo& Spec)
 	{
-		CursorStack.Push(Cursor);
-		EvaluateCursorStack();
-		return Cursor.GetHandle();
+		return Spec.Identifier == Identifier;
+	});
+
+	if (SpecIndex != INDEX_NONE)
+	{
+		TArray<FCursorInfo> Specs{DeferredSpecs[SpecIndex]};
+		DeferredSpecs.RemoveAt(SpecIndex);
+		LoadBaseCursorsAsync(MoveTemp(Specs));
+		return;
 	}
 
-	else
+	// The cursor may belong to a registry that has not been loaded yet.
+	const FSoftObjectPath* RegistryPath = RegistryCursors.Find(Identifier);
+	if (RegistryPath && UnloadedRegistries.Contains(*RegistryPath))
 	{
-		return FCursorStackElementHandle();
+		LoadStatuses.Add(Identifier, ECursorLoadStatus::Loading);
+		LoadCursorRegistry(*RegistryPath, Identifier);
 	}
 }
 
-void UCursorySystem::ModifyCursorByHandle(FCursorStackElementHandle Handle, FCursorStackElement NewCursor)
+bool UCursorySystem::RegisterCursorSet(FName SetName, const TArray<FCursorInfo>& CursorSpecs)
 {
-	if (Handle.IsValid() && CursorStack.Contains(Handle))
+	if (SetName.IsNone() || CursorSets.Contains(SetName))
 	{
-		FCursorStackElement& Cursor = CursorStack[CursorStack.Find(Handle)];
-		Cursor.CursorType = NewCursor.CursorType;
-		Cursor.CustomCursorIdentifier = NewCursor.CustomCursorIdentifier;
+		UE_LOG(LogCursory, Warning, TEXT("Tried to register cursor set [%s], but a set with that name is already registered."), *SetName.ToString());
+		return false;
 	}
-}
 
-void UCursorySystem::RemoveCursorByHandle(FCursorStackElementHandle Handle)
-{
-	if (Handle.IsValid())
+	CursorSets.Add(SetName).CursorSpecs = CursorSpecs;
+
+	// Sets registered before cursors are first loaded are loaded along with them.
+	if (LoadGeneration > 0 && FSlateApplication::IsInitialized())
 	{
-		CursorStack.Remove(Handle);
-		EvaluateCursorStack();
+		LoadCursorSet(SetName);
 	}
+
+	return true;
 }
 
-void UCursorySystem::PopCursor()
+bool UCursorySystem::RegisterCursorSet(const UCursoryRegistry* Registry)
 {
-	if (CursorStack.Num() > 1)
+	if (!Registry)
 	{
-		CursorStack.Pop();
-		EvaluateCursorStack();
+		return false;
 	}
-}
 
-void UCursorySystem::ResetCursorStack()
-{
-	while (CursorStack.Num() > 1)
+	if (!Registry->bRegisterAtRuntime)
 	{
-		CursorStack.Pop();
+		UE_LOG(LogCursory, Warning, TEXT("Registering cursor registry [%s] at runtime, but it is not marked bRegisterAtRuntime, so its cursors are already defined."), *Registry->GetPathName());
 	}
-	EvaluateCursorStack();
+
+	return RegisterCursorSet(Registry->GetFName(), Registry->CursorSpecs);
 }
 
-void UCursorySystem::EvaluateCursorStack()
+void UCursorySystem::UnregisterCursorSet(FName SetName)
 {
-	FCursorStackElement& TopCursor = CursorStack.Last(0);
+	FCursorSet CursorSet;
+	if (!CursorSets.RemoveAndCopyValue(SetName, CursorSet))
+	{
+		return;
+	}
 
-	EMouseCursor::Type OldCursorType = CachedCursorType;
-	FGameplayTag OldCustomCursorIdentifier = CachedCustomCursorIdentifier;
+	TMap<FGameplayTag, void*>* BaseCursors = LoadedCustomCursors.Find(NAME_None);
+	TArray<void*> Handles;
+	for (const FGameplayTag& Identifier : CursorSet.Identifiers)
+	{
+		LoadStatuses.Remove(Identifier);
 
-	CachedCursorType = TopCursor.CursorType;
-	CachedCustomCursorIdentifier = TopCursor.CustomCursorIdentifier;
+		void* Handle = nullptr;
+		if (BaseCursors && BaseCursors->RemoveAndCopyValue(Identifier, Handle))
+		{
+			Handles.Add(Handle);
+		}
+	}
 
-	if (CachedCursorType != OldCursorType)
+	// Unmount before freeing, in case the current cursor belongs to the set.
+	if (FSlateApplication::IsInitialized() && CursorSet.Identifiers.Contains(GetActiveCustomCursorIdentifier()))
 	{
-		CursorTypeChanged.Broadcast(CachedCursorType, OldCursorType);
+		FSlateApplication::Get().GetPlatformCursor()->SetTypeShape(EMouseCursor::Custom, nullptr);
+		ForgetMountedCursor();
 	}
 
-	if (CachedCustomCursorIdentifier != OldCustomCursorIdentifier && CachedCustomCursorIdentifier.IsValid())
+	for (void* Handle : Handles)
 	{
-		MountCustomCursor(CachedCustomCursorIdentifier);
+		ReleaseCursorHandle(Handle);
 	}
+
+	ReportCursorSharing();
 }
 
-void UCursorySystem::ClearCursorStack()
+bool UCursorySystem::IsCursorSetRegistered(FName SetName) const
 {
-	CursorStack.Empty();
-	PushBaseCursor();
+	return CursorSets.Contains(SetName);
 }
 
-void UCursorySystem::SetAutoFocusViewport(bool bActive)
+void UCursorySystem::LoadCursorSet(FName SetName)
 {
-	bAutoFocusViewport = bActive;
+	FCursorSet* CursorSet = CursorSets.Find(SetName);
+	if (!CursorSet)
+	{
+		return;
+	}
+
+	CursorSet->Serial = ++CursorSetSerial;
+	CursorSet->Identifiers.Reset();
+
+	TArray<FCursorInfo> Specs;
+	for (const FCursorInfo& CursorSpec : CursorSet->CursorSpecs)
+	{
+		if (!CursorSpec.Identifier.IsValid() || LoadStatuses.Contains(CursorSpec.Identifier))
+		{
+			UE_LOG(LogCursory, Warning, TEXT("Custom cursor [%s] in cursor set [%s] is invalid or already defined, and will be ignored."), *CursorSpec.Identifier.ToString(), *SetName.ToString());
+			continue;
+		}
+
+		CursorSet->Identifiers.Add(CursorSpec.Identifier);
+		LoadStatuses.Add(CursorSpec.Identifier, ECursorLoadStatus::Loading);
+		Specs.Add(CursorSpec);
+	}
+
+	if (Specs.Num() == 0)
+	{
+		return;
+	}
+
+	++PendingLoads;
+	LoadCursorsAsync(MoveTemp(Specs), [this, SetName, Serial = CursorSet->Serial](TMap<FGameplayTag, void*>&& Cursors)
+	{
+		--PendingLoads;
+
+		// The set was unregistered while loading, so nothing needs these handles.
+		const FCursorSet* LoadedSet = CursorSets.Find(SetName);
+		if (!LoadedSet || LoadedSet->Serial != Serial)
+		{
+			for (const TPair<FGameplayTag, void*>& Cursor : Cursors)
+			{
+				ReleaseCursorHandle(Cursor.Value);
+			}
+
+			ReportCursorSharing();
+			return;
+		}
+
+		TMap<FGameplayTag, void*>& BaseCursors = LoadedCustomCursors.FindOrAdd(NAME_None);
+		for (const FGameplayTag& Identifier : LoadedSet->Identifiers)
+		{
+			void* const* HardwareCursor = Cursors.Find(Identifier);
+			LoadStatuses.Add(Identifier, HardwareCursor ? ECursorLoadStatus::Loaded : ECursorLoadStatus::Failed);
+			if (HardwareCursor)
+			{
+				BaseCursors.Add(Identifier, *HardwareCursor);
+			}
+		}
+
+		// The current cursor may have been waiting on one of these.
+		if (Cursors.Contains(GetActiveCustomCursorIdentifier()))
+		{
+			RemountCurrentCursor();
+		}
+	});
 }
 
-void UCursorySystem::MonitorViewportStatus()
+ECursorLoadStatus UCursorySystem::GetCursorLoadStatus(FGameplayTag Identifier) const
 {
-	FSlateApplication::Get().OnPreTick().AddUObject(this, &UCursorySystem::AuditViewportStatus);
+	const ECursorLoadStatus* Status = LoadStatuses.Find(Identifier);
+	return Status ? *Status : ECursorLoadStatus::Unloaded;
 }
 
-void UCursorySystem::AuditViewportStatus(float DeltaSeconds)
+int32 UCursorySystem::GetCustomCursorCount() const
 {
-	FSlateApplication& SlateApp = FSlateApplication::Get();
-	SWidget* GameViewport = SlateApp.GetGameViewport().Get();
+	return GetCustomCursorOptions().Num();
+}
 
-	if (GameViewport && GameViewport->IsDirectlyHovered())
+FGameplayTagContainer UCursorySystem::GetCustomCursorOptions() const
+{
+	FGameplayTagContainer Options;
+	for (const FName Theme : {FName(NAME_None), ActiveTheme})
 	{
-		// If viewport lost focus along the way, restore focus
-		// (Clicking a widget may take focus)
-		const bool bShouldAutoFocus = bAutoFocusViewport.Get(GetDefault<UCursorySettings>()->bAutoFocusViewport);		
-		if (bShouldAutoFocus && !GameViewport->HasUserFocus(0).IsSet())
+		if (const TMap<FGameplayTag, void*>* Cursors = LoadedCustomCursors.Find(Theme))
 		{
-			UWidgetBlueprintLibrary::SetFocusToGameViewport();
+			for (const auto& LoadedCursorPair : *Cursors) 
+			{
+				Options.AddTag(LoadedCursorPair.Key);
+			}
 		}
 	}
+	return Options;
+}
+
+void UCursorySystem::PrewarmTheme(FName Theme)
+{
+	if (Theme.IsNone() || LoadedCustomCursors.Contains(Theme) || WarmingThemes.Contains(Theme))
+	{
+		return;
+	}
+
+	const FCursorTheme* ThemeSpec = GetDefault<UCursorySettings>()->CursorThemes.FindByPredicate([Theme](const FCursorTheme& Candidate)
+	{
+		return Candidate.Name == Theme;
+	});
+
+	if (!ThemeSpec)
+	{
+		UE_LOG(LogCursory, Warning, TEXT("Tried to pre-warm cursor theme [%s], but no such theme has been defined."), *Theme.ToString());
+		return;
+	}
+
+	WarmingThemes.Add(Theme);
+	LoadCursorsAsync(ThemeSpec->CursorSpecs.Array(), [this, Theme](TMap<FGameplayTag, void*>&& Cursors)
+	{
+		InstallTheme(Theme, MoveTemp(Cursors));
+	});
+}
+
+void UCursorySystem::InstallTheme(FName Theme, TMap<FGameplayTag, void*>&& Cursors)
+{
+	WarmingThemes.Remove(Theme);
+	LoadedCustomCursors.Add(Theme, MoveTemp(Cursors));
+
+	if (PendingTheme == Theme)
+	{
+		PendingTheme = NAME_None;
+		ActivateTheme(Theme);
+	}
+}
+
+void UCursorySystem::SetTheme(FName Theme)
+{
+	PendingTheme = NAME_None;
+
+	if (IsThemeReady(Theme))
+	{
+		if (Theme != ActiveTheme)
+		{
+			ActivateTheme(Theme);
+		}
+	}
+
+	else
+	{
+		PrewarmTheme(Theme);
+		if (WarmingThemes.Contains(Theme))
+		{
+			PendingTheme = Theme;
+		}
+	}
+}
+
+void UCursorySystem::ActivateTheme(FName Theme)
+{
+	ActiveTheme = Theme;
+
+	// The platform still holds the old theme's handle, so mount the new one.
+	RemountCurrentCursor();
+}
+
+void UCursorySystem::RemountCurrentCursor()
+{
+	// The handle may have changed (e.g. theme or scale), so look it up again; it is still only set if it differs.
+	MountedCursorIdentifier = FGameplayTag::EmptyTag;
+
+	FGameplayTag Identifier = GetActiveCustomCursorIdentifier();
+	if (Identifier.IsValid())
+	{
+		MountCustomCursor(Identifier);
+	}
+}
+
+FName UCursorySystem::GetTheme() const
+{
+	return ActiveTheme;
+}
+
+bool UCursorySystem::IsThemeReady(FName Theme) const
+{
+	return LoadedCustomCursors.Contains(Theme);
+}
+
+void UCursorySystem::SetCursorScale(float Scale)
+{
+	Scaler->SetScale(Scale);
+}
+
+float UCursorySystem::GetCursorScale() const
+{
+	return Scaler->GetScale();
+}
+
+void* UCursorySystem::FindCursorHandle(const FGameplayTag& Identifier) const
+{
+	// Active theme first, then fall back to the base cursors.
+	for (const FName Theme : {ActiveTheme, FName(NAME_None)})
+	{
+		if (const TMap<FGameplayTag, void*>* Cursors = LoadedCustomCursors.Find(Theme))
+		{
+			if (void* const* HardwareCursor = Cursors->Find(Identifier))
+			{
+				return *HardwareCursor;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void UCursorySystem::MountCustomCursor(FGameplayTag& Identifier, bool bWidget /* = false */)
+{
+	// The platform keeps the custom shape while standard cursors are shown,
+	// so returning to the mounted cursor needs neither a lookup nor a platform call.
+	if (MountedCursorHandle && Identifier == MountedCursorIdentifier)
+	{
+		++MountStats.SkippedSameCursor;
+		INC_DWORD_STAT(STAT_CursorySkippedMounts);
+		CURSORY_LATENCY_STAGE(GetCursorUserIndex(), Mount);
+		FCursoryPrefetcher::Get().RecordMount(Identifier, true);
+	}
+
+	else if (void* Cursor = FindCursorHandle(Identifier))
+	{
+		void* const Handle = Scaler->Resolve(Cursor);
+		if (Handle != MountedCursorHandle)
+		{
+			FSlateApplication::Get().GetPlatformCursor()->SetTypeShape(EMouseCursor::Custom, Handle);
+			MountedCursorHandle = Handle;
+			++MountStats.PlatformCalls;
+			INC_DWORD_STAT(STAT_CursoryPlatformMounts);
+			CURSORY_DEBUG_COUNT(Mount);
+		}
+
+		else
+		{
+			++MountStats.SkippedSameHandle;
+			INC_DWORD_STAT(STAT_CursorySkippedMounts);
+		}
+
+		MountedCursorIdentifier = Identifier;
+		CURSORY_LATENCY_STAGE(GetCursorUserIndex(), Mount);
+		FCursoryPrefetcher::Get().RecordMount(Identifier, true);
+	}
+
+	else
+	{
+		const ECursorLoadStatus* Status = LoadStatuses.Find(Identifier);
+		if (Status && *Status == ECursorLoadStatus::Unloaded)
+		{
+			// First use of a deferred cursor; it is mounted once loaded.
+			FCursoryPrefetcher::Get().RecordMount(Identifier, false);
+			RequestCursorLoad(Identifier);
+		}
+
+		else if (Status && *Status == ECursorLoadStatus::Loading)
+		{
+			FCursoryPrefetcher::Get().RecordMount(Identifier, false);
+		}
+
+		else
+		{
+			UE_LOG(LogCursory, Warning, TEXT("Tried to mount custom cursor [%s], but no such cursor has been loaded."), *Identifier.ToString());
+		}
+	}
+}
+
+const FCursoryMountStats& UCursorySystem::GetMountStats() const
+{
+	return MountStats;
+}
+
+void UCursorySystem::ResetMountStats()
+{
+	MountStats = FCursoryMountStats();
+}
+
+void UCursorySystem::ForgetMountedCursor()
+{
+	MountedCursorIdentifier = FGameplayTag::EmptyTag;
+	MountedCursorHandle = nullptr;
+}
+
+const FCursoryUserState* UCursorySystem::FindUserState(int32 UserIndex) const
+{
+	return UserStates.IsValidIndex(UserIndex) ? &UserStates[UserIndex] : nullptr;
+}
+
+FCursoryUserState* UCursorySystem::FindOrAddUserState(int32 UserIndex)
+{
+	if (UserIndex < 0 || UserIndex >= MaxUsers)
+	{
+		UE_LOG(LogCursory, Warning, TEXT("Tried to access cursor stack for user [%d], but only users 0..%d are supported."), UserIndex, MaxUsers - 1);
+		return nullptr;
+	}
+
+	// Users are stored contiguously, so create any preceding users as well.
+	while (UserStates.Num() <= UserIndex)
+	{
+		UserStates.AddDefaulted();
+		PushBaseCursor(UserStates.Num() - 1);
+	}
+
+	return &UserStates[UserIndex];
+}
+
+int32 UCursorySystem::FindUserForHandle(FCursorStackElementHandle Handle) const
+{
+	for (int32 UserIndex = 0; UserIndex < UserStates.Num(); ++UserIndex)
+	{
+		if (UserStates[UserIndex].CursorStack.Contains(Handle))
+		{
+			return UserIndex;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+int32 UCursorySystem::GetCursorUserIndex() const
+{
+	return FSlateApplication::IsInitialized() ? FSlateApplication::Get().GetCursorUser()->GetUserIndex() : 0;
+}
+
+UCursorySystem::FWindowCursorContext* UCursorySystem::FindWindowContext(const SWindow* Window)
+{
+	return Window ? WindowContexts.FindByPredicate([Window](const FWindowCursorContext& Context)
+	{
+		return Context.WindowKey == Window;
+	}) : nullptr;
+}
+
+const UCursorySystem::FWindowCursorContext* UCursorySystem::FindWindowContext(const SWindow* Window) const
+{
+	return const_cast<UCursorySystem*>(this)->FindWindowContext(Window);
+}
+
+UCursorySystem::FWindowCursorContext* UCursorySystem::FindWindowContextForHandle(FCursorStackElementHandle Handle)
+{
+	return WindowContexts.FindByPredicate([Handle](const FWindowCursorContext& Context)
+	{
+		return Context.CursorStack.Contains(Handle);
+	});
+}
+
+void UCursorySystem::RemoveWindowContext(const SWindow* Window)
+{
+	const int32 Index = WindowContexts.IndexOfByPredicate([Window](const FWindowCursorContext& Context)
+	{
+		return Context.WindowKey == Window;
+	});
+
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Hand the window's cursor back, unless it has closed.
+	if (const TSharedPtr<SWindow> PinnedWindow = WindowContexts[Index].Window.Pin())
+	{
+		PinnedWindow->SetCursor(WindowContexts[Index].PreviousCursor);
+	}
+
+	WindowContexts.RemoveAtSwap(Index);
+
+	if (ActiveWindow == Window)
+	{
+		ActiveWindow = nullptr;
+	}
+}
+
+FGameplayTag UCursorySystem::GetActiveCustomCursorIdentifier() const
+{
+	if (const FWindowCursorContext* Context = FindWindowContext(ActiveWindow))
+	{
+		return Context->CursorStack.Top().CustomCursorIdentifier;
+	}
+
+	return GetCurrentCustomCursorIdentifier(GetCursorUserIndex());
+}
+
+void UCursorySystem::MountActiveCursorIfChanged(const FGameplayTag& OldIdentifier)
+{
+	FGameplayTag Identifier = GetActiveCustomCursorIdentifier();
+	if (Identifier != OldIdentifier && Identifier.IsValid())
+	{
+		MountCustomCursor(Identifier);
+	}
+}
+
+int32 UCursorySystem::GetUserIndexForPlayer(const APlayerController* Player)
+{
+	const ULocalPlayer* LocalPlayer = Player ? Player->GetLocalPlayer() : nullptr;
+	if (LocalPlayer && FSlateApplication::IsInitialized())
+	{
+		const int32 UserIndex = FSlateApplication::Get().GetUserIndexForController(LocalPlayer->GetControllerId());
+		if (UserIndex >= 0 && UserIndex < MaxUsers)
+		{
+			return UserIndex;
+		}
+	}
+
+	return 0;
+}
+
+FCursorChanged& UCursorySystem::OnCursorTypeChanged(int32 UserIndex /* = 0 */)
+{
+	FCursoryUserState* UserState = FindOrAddUserState(UserIndex);
+	return UserState ? UserState->CursorTypeChanged : FindOrAddUserState(0)->CursorTypeChanged;
+}
+
+void UCursorySystem::BuildCompactCursorIds()
+{
+	CompactCursorIds.Reset();
+	for (const FCursorInfo& CursorSpec : GetDefault<UCursorySettings>()->CustomCursorSpecs)
+	{
+		if (CursorSpec.Identifier.IsValid())
+		{
+			CompactCursorIds.Add(CursorSpec.Identifier);
+		}
+	}
+
+	// Registry cursors are read from asset tags, so every machine agrees without loading the registries.
+	TArray<FAssetData> Registries;
+	UCursoryRegistry::FindRegistries(Registries);
+	for (const FAssetData& Registry : Registries)
+	{
+		for (const FGameplayTag& Identifier : UCursoryRegistry::GetIdentifiers(Registry))
+		{
+			CompactCursorIds.AddUnique(Identifier);
+		}
+	}
+
+	// Sort by name, so that ids do not depend on set order.
+	CompactCursorIds.Sort([](const FGameplayTag& A, const FGameplayTag& B)
+	{
+		return A.GetTagName().LexicalLess(B.GetTagName());
+	});
+
+	CompactCursorIdsByIdentifier.Reset();
+	for (int32 Index = 0; Index < CompactCursorIds.Num(); ++Index)
+	{
+		CompactCursorIdsByIdentifier.Add(CompactCursorIds[Index], static_cast<uint16>(EMouseCursor::TotalCursorCount + Index));
+	}
+}
+
+uint16 UCursorySystem::GetCompactCursorId(EMouseCursor::Type CursorType, const FGameplayTag& Identifier) const
+{
+	if (CursorType == EMouseCursor::Custom && Identifier.IsValid())
+	{
+		const uint16* CompactId = CompactCursorIdsByIdentifier.Find(Identifier);
+		return CompactId ? *CompactId : InvalidCompactCursorId;
+	}
+
+	return static_cast<uint16>(CursorType);
+}
+
+bool UCursorySystem::ResolveCompactCursorId(uint16 CompactId, EMouseCursor::Type& OutCursorType, FGameplayTag& OutIdentifier) const
+{
+	if (CompactId < EMouseCursor::TotalCursorCount)
+	{
+		OutCursorType = static_cast<EMouseCursor::Type>(CompactId);
+		OutIdentifier = FGameplayTag::EmptyTag;
+		return true;
+	}
+
+	const int32 Index = CompactId - EMouseCursor::TotalCursorCount;
+	if (CompactCursorIds.IsValidIndex(Index))
+	{
+		OutCursorType = EMouseCursor::Custom;
+		OutIdentifier = CompactCursorIds[Index];
+		return true;
+	}
+
+	return false;
+}
+
+void UCursorySystem::PushBaseCursor(int32 UserIndex)
+{
+	const FCursorStackElementHandle Handle = FCursorStackElementHandle::Generate();
+	UserStates[UserIndex].CursorStack.Push(Handle, EMouseCursor::Default, FGameplayTag::EmptyTag);
+	EvaluateCursorStack(UserIndex, Handle);
+}
+
+void UCursorySystem::ModifyBaseCursor(const FCursorStackElement& Cursor, bool bIgnoreType /*= false*/, bool bIgnoreCustom /*= false*/, int32 UserIndex /*= 0*/)
+{
+	FCursoryUserState* UserState = FindOrAddUserState(UserIndex);
+	if (!UserState)
+	{
+		return;
+	}
+
+	CURSORY_LATENCY_REQUEST(UserIndex, Base);
+
+	if (!bIgnoreType)
+	{
+		UserState->CursorStack.Bottom().CursorType = Cursor.CursorType;
+	}
+
+	if (!bIgnoreCustom)
+	{
+		UserState->CursorStack.Bottom().CustomCursorIdentifier = Cursor.CustomCursorIdentifier;
+	}
+
+	EvaluateCursorStack(UserIndex, UserState->CursorStack.Bottom().Handle);
+}
+
+FCursorStackElementHandle UCursorySystem::PushCursor(const FCursorStackElement& Cursor, int32 UserIndex /*= 0*/)
+{
+	FCursoryUserState* UserState = FindOrAddUserState(UserIndex);
+	if (UserState && Cursor.GetHandle().IsValid())
+	{
+		CURSORY_LATENCY_REQUEST(UserIndex, Push);
+		UserState->CursorStack.Push(Cursor.GetHandle(), Cursor.CursorType, Cursor.CustomCursorIdentifier);
+		EvaluateCursorStack(UserIndex, Cursor.GetHandle());
+		return Cursor.GetHandle();
+	}
+
+	else
+	{
+		return FCursorStackElementHandle();
+	}
+}
+
+void UCursorySystem::ModifyCursorByHandle(FCursorStackElementHandle Handle, const FCursorStackElement& NewCursor)
+{
+	const int32 UserIndex = Handle.IsValid() ? FindUserForHandle(Handle) : INDEX_NONE;
+	if (UserIndex != INDEX_NONE)
+	{
+		FCursoryStackEntry& Cursor = *UserStates[UserIndex].CursorStack.Find(Handle);
+		CURSORY_LATENCY_REQUEST(UserIndex, Modify);
+		Cursor.CursorType = NewCursor.CursorType;
+		Cursor.CustomCursorIdentifier = NewCursor.CustomCursorIdentifier;
+		EvaluateCursorStack(UserIndex, Handle);
+	}
+
+	else if (FWindowCursorContext* Context = Handle.IsValid() ? FindWindowContextForHandle(Handle) : nullptr)
+	{
+		const FGameplayTag OldIdentifier = GetActiveCustomCursorIdentifier();
+		FCursoryStackEntry& Cursor = *Context->CursorStack.Find(Handle);
+		Cursor.CursorType = NewCursor.CursorType;
+		Cursor.CustomCursorIdentifier = NewCursor.CustomCursorIdentifier;
+		MountActiveCursorIfChanged(OldIdentifier);
+	}
+}
+
+void UCursorySystem::RemoveCursorByHandle(FCursorStackElementHandle Handle)
+{
+	const int32 UserIndex = Handle.IsValid() ? FindUserForHandle(Handle) : INDEX_NONE;
+	if (UserIndex != INDEX_NONE)
+	{
+		CURSORY_LATENCY_REQUEST(UserIndex, Remove);
+		UserStates[UserIndex].CursorStack.Remove(Handle);
+		EvaluateCursorStack(UserIndex, Handle);
+	}
+
+	else if (FWindowCursorContext* Context = Handle.IsValid() ? FindWindowContextForHandle(Handle) : nullptr)
+	{
+		const FGameplayTag OldIdentifier = GetActiveCustomCursorIdentifier();
+		Context->CursorStack.Remove(Handle);
+		if (Context->CursorStack.Num() == 0)
+		{
+			RemoveWindowContext(Context->WindowKey);
+		}
+
+		MountActiveCursorIfChanged(OldIdentifier);
+	}
+}
+
+void UCursorySystem::PopCursor(int32 UserIndex /*= 0*/)
+{
+	FCursoryUserState* UserState = FindOrAddUserState(UserIndex);
+	if (UserState && UserState->CursorStack.Num() > 1)
+	{
+		CURSORY_LATENCY_REQUEST(UserIndex, Pop);
+		const FCursorStackElementHandle Handle = UserState->CursorStack.Top().Handle;
+		UserState->CursorStack.Pop();
+		EvaluateCursorStack(UserIndex, Handle);
+	}
+}
+
+void UCursorySystem::ResetCursorStack(int32 UserIndex /*= 0*/)
+{
+	FCursoryUserState* UserState = FindOrAddUserState(UserIndex);
+	if (!UserState)
+	{
+		return;
+	}
+
+	CURSORY_LATENCY_REQUEST(UserIndex, Reset);
+	const FCursorStackElementHandle Handle = UserState->CursorStack.Top().Handle;
+	UserState->CursorStack.Truncate(1);
+	EvaluateCursorStack(UserIndex, Handle);
+}
+
+FCursorStackElementHandle UCursorySystem::PushWindowCursor(const TSharedRef<SWindow>& Window, const FCursorStackElement& Cursor)
+{
+	if (!Cursor.GetHandle().IsValid())
+	{
+		return FCursorStackElementHandle();
+	}
+
+	const FGameplayTag OldIdentifier = GetActiveCustomCursorIdentifier();
+
+	FWindowCursorContext* Context = FindWindowContext(&Window.Get());
+	if (!Context)
+	{
+		Context = &WindowContexts.AddDefaulted_GetRef();
+		Context->Window = Window;
+		Context->WindowKey = &Window.Get();
+
+		// Slate only exposes the evaluated cursor, so a bound one is restored as its current value.
+		Context->PreviousCursor = Window->GetCursor();
+
+		// The window itself answers Slate's cursor query for any of its widgets that do not.
+		TAttribute<TOptional<EMouseCursor::Type>> WindowCursor;
+		WindowCursor.BindUObject(this, &UCursorySystem::GetWindowCursorType, TWeakPtr<SWindow>(Window));
+		Window->SetCursor(WindowCursor);
+	}
+
+	Context->CursorStack.Push(Cursor.GetHandle(), Cursor.CursorType, Cursor.CustomCursorIdentifier);
+	MountActiveCursorIfChanged(OldIdentifier);
+	return Cursor.GetHandle();
+}
+
+void UCursorySystem::ResetWindowCursorStack(const TSharedRef<SWindow>& Window)
+{
+	if (FindWindowContext(&Window.Get()))
+	{
+		const FGameplayTag OldIdentifier = GetActiveCustomCursorIdentifier();
+		RemoveWindowContext(&Window.Get());
+		MountActiveCursorIfChanged(OldIdentifier);
+	}
+}
+
+TOptional<EMouseCursor::Type> UCursorySystem::GetWindowCursorType(TWeakPtr<SWindow> Window) const
+{
+	const TSharedPtr<SWindow> PinnedWindow = Window.Pin();
+	if (const FWindowCursorContext* Context = FindWindowContext(PinnedWindow.Get()))
+	{
+		return Context->CursorStack.Top().CursorType;
+	}
+
+	return TOptional<EMouseCursor::Type>();
+}
+
+void UCursorySystem::EvaluateCursorStack(int32 UserIndex, FCursorStackElementHandle Cause)
+{
+	FCursoryUserState& UserState = UserStates[UserIndex];
+	const FCursoryStackEntry& TopCursor = UserState.CursorStack.Top();
+
+	EMouseCursor::Type OldCursorType = UserState.CachedCursorType;
+	FGameplayTag OldCustomCursorIdentifier = UserState.CachedCustomCursorIdentifier;
+
+	UserState.CachedCursorType = TopCursor.CursorType;
+	UserState.CachedCustomCursorIdentifier = TopCursor.CustomCursorIdentifier;
+	CURSORY_LATENCY_STAGE(UserIndex, Evaluate);
+	CURSORY_DEBUG_COUNT(Evaluation);
+
+	if (UserState.CachedCursorType != OldCursorType)
+	{
+		UserState.CursorTypeChanged.Broadcast(UserState.CachedCursorType, OldCursorType);
+	}
+
+	if (UserState.CachedCursorType != OldCursorType || UserState.CachedCustomCursorIdentifier != OldCustomCursorIdentifier)
+	{
+		QueueCursorChange(UserIndex, OldCursorType, OldCustomCursorIdentifier, Cause);
+	}
+
+	// Only the user driving the hardware cursor gets to mount custom cursors, and only while no window overrides it.
+	if (UserState.CachedCustomCursorIdentifier != OldCustomCursorIdentifier && UserIndex == GetCursorUserIndex() && !ActiveWindow)
+	{
+		if (UserState.CachedCustomCursorIdentifier.IsValid())
+		{
+			MountCustomCursor(UserState.CachedCustomCursorIdentifier);
+		}
+
+		if (GetDefault<UCursorySettings>()->bPrefetchCursors)
+		{
+			PrefetchLikelyCursors(OldCustomCursorIdentifier, UserState.CachedCustomCursorIdentifier);
+		}
+	}
+}
+
+void UCursorySystem::PrefetchLikelyCursors(const FGameplayTag& OldIdentifier, const FGameplayTag& NewIdentifier)
+{
+	FCursoryPrefetcher& Prefetcher = FCursoryPrefetcher::Get();
+	Prefetcher.RecordTransition(OldIdentifier, NewIdentifier);
+
+	// Only on-demand cursors that have not been requested yet need a head start.
+	TArray<FGameplayTag, TInlineAllocator<4>> LikelyNext;
+	Prefetcher.GetLikelyNext(NewIdentifier, LikelyNext);
+	for (const FGameplayTag& Identifier : LikelyNext)
+	{
+		if (GetCursorLoadStatus(Identifier) == ECursorLoadStatus::Unloaded && LoadStatuses.Contains(Identifier))
+		{
+			Prefetcher.RecordPrefetch(Identifier);
+			RequestCursorLoad(Identifier);
+		}
+	}
+}
+
+bool FCursoryCursorChangeFilter::Matches(const FCursoryCursorChange& Change) const
+{
+	if (UserIndex != INDEX_NONE && UserIndex != Change.UserIndex)
+	{
+		return false;
+	}
+
+	if (Tags.IsEmpty())
+	{
+		return true;
+	}
+
+	auto MatchesTag = [this](const FGameplayTag& Tag)
+	{
+		return bExactMatch ? Tag.MatchesAnyExact(Tags) : Tag.MatchesAny(Tags);
+	};
+
+	return MatchesTag(Change.OldCustomCursorIdentifier) || MatchesTag(Change.NewCustomCursorIdentifier);
+}
+
+FDelegateHandle UCursorySystem::SubscribeToCursorChanges(const FCursoryCursorChangeFilter& Filter, FOnCursoryCursorChanges Delegate)
+{
+	// Adding while dispatching could reallocate the delegate being executed.
+	TArray<FCursorChangeSubscription>& Subscriptions = bDispatchingCursorChanges ? AddedCursorChangeSubscriptions : CursorChangeSubscriptions;
+
+	FCursorChangeSubscription& Subscription = Subscriptions.AddDefaulted_GetRef();
+	Subscription.Handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+	Subscription.Filter = Filter;
+	Subscription.Delegate = MoveTemp(Delegate);
+
+	// Checking for changes every frame is cheaper than adding a ticker on every frame with a change.
+	if (!DispatchChangesHandle.IsValid())
+	{
+		DispatchChangesHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UCursorySystem::DispatchCursorChanges));
+	}
+
+	return Subscription.Handle;
+}
+
+void UCursorySystem::UnsubscribeFromCursorChanges(FDelegateHandle Handle)
+{
+	for (TArray<FCursorChangeSubscription>* Subscriptions : {&CursorChangeSubscriptions, &AddedCursorChangeSubscriptions})
+	{
+		for (FCursorChangeSubscription& Subscription : *Subscriptions)
+		{
+			if (Subscription.Handle == Handle)
+			{
+				Subscription.Delegate.Unbind();
+			}
+		}
+	}
+
+	// Removal would shift the subscriptions being dispatched to, so wait until dispatch is done.
+	if (!bDispatchingCursorChanges)
+	{
+		CompactCursorChangeSubscriptions();
+	}
+}
+
+void UCursorySystem::CompactCursorChangeSubscriptions()
+{
+	CursorChangeSubscriptions.RemoveAll([](const FCursorChangeSubscription& Subscription)
+	{
+		return !Subscription.Delegate.IsBound();
+	});
+
+	for (FCursorChangeSubscription& Subscription : AddedCursorChangeSubscriptions)
+	{
+		if (Subscription.Delegate.IsBound())
+		{
+			CursorChangeSubscriptions.Add(MoveTemp(Subscription));
+		}
+	}
+	AddedCursorChangeSubscriptions.Reset();
+
+	// Changes are only tracked while someone is listening.
+	if (CursorChangeSubscriptions.Num() == 0)
+	{
+		for (FCursoryUserState& UserState : UserStates)
+		{
+			UserState.PendingChange.Reset();
+		}
+
+		if (DispatchChangesHandle.IsValid())
+		{
+			FTSTicker::GetCoreTicker().RemoveTicker(DispatchChangesHandle);
+			DispatchChangesHandle.Reset();
+		}
+	}
+}
+
+void UCursorySystem::QueueCursorChange(int32 UserIndex, EMouseCursor::Type OldCursorType, const FGameplayTag& OldCustomCursorIdentifier, FCursorStackElementHandle Cause)
+{
+	if (CursorChangeSubscriptions.Num() == 0)
+	{
+		return;
+	}
+
+	FCursoryUserState& UserState = UserStates[UserIndex];
+
+	// The first change of the frame holds the old state; later ones only move the new state.
+	if (!UserState.PendingChange.IsSet())
+	{
+		FCursoryCursorChange Change;
+		Change.UserIndex = UserIndex;
+		Change.OldCursorType = OldCursorType;
+		Change.OldCustomCursorIdentifier = OldCustomCursorIdentifier;
+		UserState.PendingChange = Change;
+	}
+
+	FCursoryCursorChange& Change = UserState.PendingChange.GetValue();
+	Change.NewCursorType = UserState.CachedCursorType;
+	Change.NewCustomCursorIdentifier = UserState.CachedCustomCursorIdentifier;
+	Change.Cause = Cause;
+}
+
+bool UCursorySystem::DispatchCursorChanges(float DeltaTime)
+{
+	TArray<FCursoryCursorChange, TInlineAllocator<MaxUsers>> Changes;
+	for (FCursoryUserState& UserState : UserStates)
+	{
+		if (UserState.PendingChange.IsSet())
+		{
+			const FCursoryCursorChange& Change = UserState.PendingChange.GetValue();
+			if (Change.OldCursorType != Change.NewCursorType || Change.OldCustomCursorIdentifier != Change.NewCustomCursorIdentifier)
+			{
+				Changes.Add(Change);
+			}
+			UserState.PendingChange.Reset();
+		}
+	}
+
+	if (Changes.Num() == 0)
+	{
+		return true;
+	}
+
+	// Subscribers may subscribe or unsubscribe while being notified, which leaves the array in place until
+	// dispatch is done: unsubscribing only unbinds, and new subscriptions hear from the next frame's changes.
+	bDispatchingCursorChanges = true;
+	TArray<FCursoryCursorChange, TInlineAllocator<MaxUsers>> MatchingChanges;
+	for (int32 Index = 0; Index < CursorChangeSubscriptions.Num(); ++Index)
+	{
+		if (!CursorChangeSubscriptions[Index].Delegate.IsBound())
+		{
+			continue;
+		}
+
+		MatchingChanges.Reset();
+		for (const FCursoryCursorChange& Change : Changes)
+		{
+			if (CursorChangeSubscriptions[Index].Filter.Matches(Change))
+			{
+				MatchingChanges.Add(Change);
+			}
+		}
+
+		if (MatchingChanges.Num() > 0)
+		{
+			CursorChangeSubscriptions[Index].Delegate.ExecuteIfBound(MatchingChanges);
+		}
+	}
+	bDispatchingCursorChanges = false;
+
+	// Stops ticking if everyone unsubscribed meanwhile.
+	CompactCursorChangeSubscriptions();
+	return true;
+}
+
+void UCursorySystem::ClearCursorStacks()
+{
+	FindOrAddUserState(0);
+
+	for (int32 UserIndex = 0; UserIndex < UserStates.Num(); ++UserIndex)
+	{
+		UserStates[UserIndex].CursorStack.Truncate(0);
+		PushBaseCursor(UserIndex);
+	}
+}
+
+void UCursorySystem::SetAutoFocusViewport(bool bActive)
+{
+	bAutoFocusViewport = bActive;
+}
+
+void UCursorySystem::SetGamepadCursorEnabled(bool bEnabled)
+{
+	if (bEnabled == bGamepadCursorRegistered || !FSlateApplication::IsInitialized())
+	{
+		return;
+	}
+
+	if (bEnabled)
+	{
+		bGamepadCursorRegistered = FSlateApplication::Get().RegisterInputPreProcessor(GamepadCursor.ToSharedRef());
+	}
+
+	else
+	{
+		GamepadCursor->Reset();
+		FSlateApplication::Get().UnregisterInputPreProcessor(GamepadCursor.ToSharedRef());
+		bGamepadCursorRegistered = false;
+	}
+}
+
+bool UCursorySystem::IsGamepadCursorEnabled() const
+{
+	return bGamepadCursorRegistered;
+}
+
+void UCursorySystem::AddGamepadCursorTarget(const TSharedRef<SWidget>& Widget)
+{
+	GamepadCursor->AddTarget(Widget);
+}
+
+void UCursorySystem::RemoveGamepadCursorTarget(const TSharedRef<SWidget>& Widget)
+{
+	GamepadCursor->RemoveTarget(Widget);
+}
+
+FCursoryMouseSampleReader UCursorySystem::CreateMouseSampleReader()
+{
+	TSharedPtr<FCursoryMouseSampleBuffer> Buffer = MouseSampler.IsValid() ? MouseSampler->GetBuffer() : nullptr;
+	if (!Buffer.IsValid())
+	{
+		if (!FSlateApplication::IsInitialized())
+		{
+			UE_LOG(LogCursory, Warning, TEXT("Tried to create a mouse sample reader before Slate was initialized."));
+			return FCursoryMouseSampleReader();
+		}
+
+		// Readers own the buffer, so the sampler is released along with the last of them.
+		TWeakObjectPtr<UCursorySystem> WeakThis(this);
+		Buffer = MakeShareable(new FCursoryMouseSampleBuffer(), [WeakThis](FCursoryMouseSampleBuffer* ReleasedBuffer)
+		{
+			delete ReleasedBuffer;
+
+			auto Release = [WeakThis]()
+			{
+				if (UCursorySystem* This = WeakThis.Get())
+				{
+					This->ReleaseMouseSampler(false);
+				}
+			};
+
+			if (IsInGameThread())
+			{
+				Release();
+			}
+
+			else
+			{
+				AsyncTask(ENamedThreads::GameThread, MoveTemp(Release));
+			}
+		});
+
+		// A sampler whose readers have just gone may not have been released yet.
+		ReleaseMouseSampler(true);
+
+		// Register first, so moves are recorded even if a later processor consumes them.
+		MouseSampler = MakeShared<FCursoryMouseSampler>(Buffer.ToSharedRef());
+		FSlateApplication::Get().RegisterInputPreProcessor(MouseSampler, 0);
+	}
+
+	return FCursoryMouseSampleReader(Buffer.ToSharedRef());
+}
+
+void UCursorySystem::ReleaseMouseSampler(bool bForce)
+{
+	if (!MouseSampler.IsValid() || (!bForce && MouseSampler->GetBuffer().IsValid()))
+	{
+		return;
+	}
+
+	if (FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().UnregisterInputPreProcessor(MouseSampler);
+	}
+
+	MouseSampler.Reset();
+}
+
+void UCursorySystem::SetHeatmapCaptureEnabled(bool bEnabled)
+{
+	if (bEnabled == Heatmap.IsValid())
+	{
+		return;
+	}
+
+	if (bEnabled)
+	{
+		FCursoryMouseSampleReader Reader = CreateMouseSampleReader();
+		if (Reader.IsValid())
+		{
+			const UCursorySettings* Settings = GetDefault<UCursorySettings>();
+			Heatmap = MakeShared<FCursoryHeatmap>(MoveTemp(Reader), Settings->HeatmapResolution, Settings->HeatmapFlushInterval);
+		}
+	}
+
+	else
+	{
+		// Saves on destruction, in the background.
+		Heatmap.Reset();
+	}
+}
+
+bool UCursorySystem::IsHeatmapCaptureEnabled() const
+{
+	return Heatmap.IsValid();
+}
+
+void UCursorySystem::FlushHeatmap()
+{
+	if (Heatmap.IsValid())
+	{
+		Heatmap->Flush();
+	}
+}
+
+void UCursorySystem::MonitorViewportStatus()
+{
+	FSlateApplication::Get().OnPreTick().AddUObject(this, &UCursorySystem::AuditViewportStatus);
+
+#if CURSORY_LATENCY_TRACKING
+	FSlateApplication::Get().OnPostTick().AddLambda([](float DeltaTime)
+	{
+		FCursoryLatencyTracker::Get().RecordSlateTick();
+	});
+#endif
+}
+
+void UCursorySystem::AuditViewportStatus(float DeltaSeconds)
+{
+	AuditHoveredWindow();
+
+	FSlateApplication& SlateApp = FSlateApplication::Get();
+	TSharedPtr<SViewport> GameViewport = SlateApp.GetGameViewport();
+
+	if (!GameViewport.IsValid())
+	{
+		return;
+	}
+
+	// If viewport lost focus along the way, restore focus
+	// (Clicking a widget may take focus)
+	const bool bShouldAutoFocus = bAutoFocusViewport.Get(GetDefault<UCursorySettings>()->bAutoFocusViewport);
+	if (!bShouldAutoFocus)
+	{
+		return;
+	}
+
+	for (int32 UserIndex = 0; UserIndex < UserStates.Num(); ++UserIndex)
+	{
+		TSharedPtr<FSlateUser> SlateUser = SlateApp.GetUser(UserIndex);
+		if (SlateUser.IsValid() && SlateUser->IsWidgetDirectlyUnderCursor(GameViewport) && !GameViewport->HasUserFocus(UserIndex).IsSet())
+		{
+			SlateApp.SetUserFocusToGameViewport(UserIndex);
+			CURSORY_DEBUG_COUNT(AutoFocus);
+		}
+	}
+}
+
+void UCursorySystem::AuditHoveredWindow()
+{
+	// Windows without their own stack cost nothing.
+	if (WindowContexts.Num() == 0)
+	{
+		return;
+	}
+
+	const FGameplayTag OldIdentifier = GetActiveCustomCursorIdentifier();
+
+	// Windows may have closed since the last audit.
+	for (int32 Index = WindowContexts.Num() - 1; Index >= 0; --Index)
+	{
+		if (!WindowContexts[Index].Window.IsValid())
+		{
+			RemoveWindowContext(WindowContexts[Index].WindowKey);
+		}
+	}
+
+	// Slate already tracks the widgets under the cursor, so no hit test is needed.
+	TSharedPtr<FSlateUser> CursorUser = FSlateApplication::Get().GetCursorUser();
+	TSharedPtr<SWindow> HoveredWindow = CursorUser.IsValid() ? CursorUser->GetLastWidgetsUnderCursor().Window.Pin() : nullptr;
+	const SWindow* Window = FindWindowContext(HoveredWindow.Get()) ? HoveredWindow.Get() : nullptr;
+
+	// Only mounts on an actual change (e.g. not between windows that show the same cursor).
+	ActiveWindow = Window;
+	MountActiveCursorIfChanged(OldIdentifier);
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
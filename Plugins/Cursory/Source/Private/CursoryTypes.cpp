@@ -2,6 +2,35 @@
 
 #include "CursoryTypes.h"
 
+namespace CursoryTypes
+{
+	/** Names of the standard cursor types, in EMouseCursor order. */
+	const TCHAR* CursorTypeNames[] =
+	{
+		TEXT("None"),
+		TEXT("Default"),
+		TEXT("TextEditBeam"),
+		TEXT("ResizeLeftRight"),
+		TEXT("ResizeUpDown"),
+		TEXT("ResizeSouthEast"),
+		TEXT("ResizeSouthWest"),
+		TEXT("CardinalCross"),
+		TEXT("Crosshairs"),
+		TEXT("Hand"),
+		TEXT("GrabHand"),
+		TEXT("GrabHandClosed"),
+		TEXT("SlashedCircle"),
+		TEXT("EyeDropper"),
+		TEXT("Custom")
+	};
+	static_assert(UE_ARRAY_COUNT(CursorTypeNames) == EMouseCursor::TotalCursorCount, "Cursor type names are out of date.");
+}
+
+const TCHAR* LexToString(EMouseCursor::Type CursorType)
+{
+	return CursorType >= 0 && CursorType < EMouseCursor::TotalCursorCount ? CursoryTypes::CursorTypeNames[CursorType] : TEXT("Invalid");
+}
+
 FCursorStackElementHandle FCursorStackElementHandle::Generate()
 {
 	static int32 Id{0};
@@ -16,6 +45,11 @@ bool FCursorStackElementHandle::IsValid() const
 	return Id != -1;
 }
 
+FString FCursorStackElementHandle::ToString() const
+{
+	return IsValid() ? FString::Printf(TEXT("#%d"), Id) : TEXT("#invalid");
+}
+
 FCursorStackElement::FCursorStackElement(FCursorStackElementHandle InHandle)
 	: Handle(InHandle)
 {
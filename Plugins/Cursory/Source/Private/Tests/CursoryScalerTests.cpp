@@ -0,0 +1,33 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "Misc/AutomationTest.h"
+#include "CursoryScaler.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCursoryScalerResampleKeepsAlphaTest, "Cursory.Scaler.ResampleKeepsAlpha", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCursoryScalerResampleKeepsAlphaTest::RunTest(const FString& Parameters)
+{
+	// A transparent cursor with a single opaque pixel in the middle.
+	constexpr int32 Size = 8;
+	FCursoryDecodedCursor Source;
+	Source.Width = Size;
+	Source.Height = Size;
+	Source.Pixels.SetNumZeroed(Size * Size * sizeof(FColor));
+	reinterpret_cast<FColor*>(Source.Pixels.GetData())[Size / 2 * Size + Size / 2] = FColor::White;
+
+	for (const float Scale : {0.5f, 2.0f})
+	{
+		const FCursoryDecodedCursor Scaled = FCursoryScaler::Resample(Source, Scale);
+		const FColor* Pixels = reinterpret_cast<const FColor*>(Scaled.Pixels.GetData());
+
+		TestEqual(FString::Printf(TEXT("Width at scale %.1f"), Scale), Scaled.Width, FMath::RoundToInt(Size * Scale));
+		TestEqual(FString::Printf(TEXT("Corner alpha at scale %.1f"), Scale), Pixels[0].A, static_cast<uint8>(0));
+		TestEqual(FString::Printf(TEXT("Opposite corner alpha at scale %.1f"), Scale), Pixels[Scaled.Width * Scaled.Height - 1].A, static_cast<uint8>(0));
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,48 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#include "Misc/AutomationTest.h"
+#include "CursoryStack.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCursoryStackInlineDepthTest, "Cursory.Stack.InlineDepth", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCursoryStackInlineDepthTest::RunTest(const FString& Parameters)
+{
+	FCursoryStack Stack;
+	TArray<FCursorStackElementHandle> Handles;
+
+	// Up to the inline depth, pushes, removals and pops never touch the heap.
+	for (int32 Round = 0; Round < 2; ++Round)
+	{
+		Handles.Reset();
+		for (int32 Index = 0; Index < FCursoryStack::InlineDepth; ++Index)
+		{
+			Handles.Add(FCursorStackElementHandle::Generate());
+			Stack.Push(Handles.Last(), EMouseCursor::Hand, FGameplayTag::EmptyTag);
+			TestEqual(FString::Printf(TEXT("Heap size at depth %d"), Stack.Num()), Stack.GetHeapSize(), static_cast<SIZE_T>(0));
+		}
+
+		TestTrue(TEXT("Remove from the middle"), Stack.Remove(Handles[FCursoryStack::InlineDepth / 2]));
+		TestFalse(TEXT("Removed handle is gone"), Stack.Contains(Handles[FCursoryStack::InlineDepth / 2]));
+		TestEqual(TEXT("Heap size after removal"), Stack.GetHeapSize(), static_cast<SIZE_T>(0));
+
+		while (Stack.Num() > 0)
+		{
+			Stack.Pop();
+			TestEqual(FString::Printf(TEXT("Heap size after pop to depth %d"), Stack.Num()), Stack.GetHeapSize(), static_cast<SIZE_T>(0));
+		}
+	}
+
+	// Past it, the stack spills to the heap.
+	for (int32 Index = 0; Index <= FCursoryStack::InlineDepth; ++Index)
+	{
+		Stack.Push(FCursorStackElementHandle::Generate(), EMouseCursor::Hand, FGameplayTag::EmptyTag);
+	}
+	TestTrue(TEXT("Heap size past the inline depth"), Stack.GetHeapSize() > 0);
+	TestEqual(TEXT("Depth past the inline depth"), Stack.Num(), FCursoryStack::InlineDepth + 1);
+
+	return true;
+}
+
+#endif
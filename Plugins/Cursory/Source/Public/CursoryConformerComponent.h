@@ -12,6 +12,8 @@
  * dictated by the Cursory system. This allows you to change cursors
  * in one central location (Cursory System), instead of in multiple 
  * locations.
+ * Only changes for the local user driven by the owning PlayerController
+ * are conformed to.
  */
 UCLASS(meta=(BlueprintSpawnableComponent = true))
 class UCursoryConformerComponent : public UActorComponent
@@ -26,10 +28,21 @@ private:
 
 	void Activate(bool bReset) override;
 	void Deactivate() override;
+	void BeginPlay() override;
+
+	/** 
+	 * Resolves the owning player's user again, moving the subscription over if it changed.
+	 * Retries every frame until a local PlayerController has been given its LocalPlayer.
+	 */
+	void BindToPlayerUser();
+
 	void ConformInitialCursorState();
 	void ListenForCursorChanges();
 	void StopListeningForCursorChanges();
 	void OnCursorChange(EMouseCursor::Type Cursor, EMouseCursor::Type OldCursor);
 
 	FDelegateHandle CursorChangeCallbackHandle;
+
+	/** Slate user index of the owning player. */
+	int32 UserIndex{0};
 };
@@ -10,8 +10,10 @@
 #include "CursoryFunctionLibrary.generated.h"
 
 class UWidget;
+class APlayerController;
 class UUserWidget;
 class SWidget;
+class UCursoryRegistry;
 
 /**
  * Function library for easy access to Cursory functionality.
@@ -25,24 +27,24 @@ class UCursoryFunctionLibrary : public UBlueprintFunctionLibrary
 public:
 
 	/** Reset the base cursor to default. */
-	UFUNCTION(BlueprintCallable, Category = "Cursory")
-	static void ResetBaseCursor();
+	UFUNCTION(BlueprintCallable, Category = "Cursory", meta=(AdvancedDisplay="UserIndex"))
+	static void ResetBaseCursor(int32 UserIndex = 0);
 
 	/** Set the base cursor to a standard type. */
-	UFUNCTION(BlueprintCallable, Category = "Cursory")
-	static void UseBaseStandardCursor(EMouseCursor::Type Cursor);
+	UFUNCTION(BlueprintCallable, Category = "Cursory", meta=(AdvancedDisplay="UserIndex"))
+	static void UseBaseStandardCursor(EMouseCursor::Type Cursor, int32 UserIndex = 0);
 
 	/** Set the base cursor to a custom type. */
-	UFUNCTION(BlueprintCallable, Category = "Cursory")
-	static void UseBaseCustomCursor(FGameplayTag Identifier);
+	UFUNCTION(BlueprintCallable, Category = "Cursory", meta=(AdvancedDisplay="UserIndex"))
+	static void UseBaseCustomCursor(FGameplayTag Identifier, int32 UserIndex = 0);
 
 	/** Push a (standard) cursor onto the stack. */
-	UFUNCTION(BlueprintCallable, Category = "Cursory")
-	static FCursorStackElementHandle PushStandardCursor(EMouseCursor::Type Cursor);
+	UFUNCTION(BlueprintCallable, Category = "Cursory", meta=(AdvancedDisplay="UserIndex"))
+	static FCursorStackElementHandle PushStandardCursor(EMouseCursor::Type Cursor, int32 UserIndex = 0);
 
 	/** Push a (custom) cursor onto the stack. */
-	UFUNCTION(BlueprintCallable, Category = "Cursory")
-	static FCursorStackElementHandle PushCustomCursor(FGameplayTag Identifier);
+	UFUNCTION(BlueprintCallable, Category = "Cursory", meta=(AdvancedDisplay="UserIndex"))
+	static FCursorStackElementHandle PushCustomCursor(FGameplayTag Identifier, int32 UserIndex = 0);
 
 	/** 
 	 * Update a cursor on the stack to standard, by handle.
@@ -66,23 +68,72 @@ public:
 	 * Pop a cursor from the stack.
 	 * Does nothing if only the base cursor is on the stack.
 	 */
-	UFUNCTION(BlueprintCallable, Category = "Cursory")
-	static void PopCursor();
+	UFUNCTION(BlueprintCallable, Category = "Cursory", meta=(AdvancedDisplay="UserIndex"))
+	static void PopCursor(int32 UserIndex = 0);
 
 	/** Reset cursor stack (clear all stack elements except base). */
+	UFUNCTION(BlueprintCallable, Category = "Cursory", meta=(AdvancedDisplay="UserIndex"))
+	static void ResetCursorStack(int32 UserIndex = 0);
+
+	/** 
+	 * Switch cursor theme (None for the base cursors).
+	 * Themes that have not been pre-warmed are loaded in the background first.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Cursory|Theme")
+	static void SetCursorTheme(FName Theme);
+
+	/** Load a cursor theme in the background, so that switching to it is instant. */
+	UFUNCTION(BlueprintCallable, Category = "Cursory|Theme")
+	static void PrewarmCursorTheme(FName Theme);
+
+	/** Get the active cursor theme (None for the base cursors). */
+	UFUNCTION(BlueprintPure, Category = "Cursory|Theme")
+	static FName GetCursorTheme();
+
+	/** 
+	 * Set the cursor size multiplier (e.g. from an accessibility slider).
+	 * Resized cursors are generated in the background and cached per size.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Cursory")
+	static void SetCursorScale(float Scale = 1.0f);
+
+	/** Get the cursor size multiplier. */
+	UFUNCTION(BlueprintPure, Category = "Cursory")
+	static float GetCursorScale();
+
+	/** Get the load status of a custom cursor. */
+	UFUNCTION(BlueprintPure, Category = "Cursory")
+	static ECursorLoadStatus GetCursorLoadStatus(FGameplayTag Identifier);
+
+	/** Start loading a deferred custom cursor in the background, ahead of its first use. */
+	UFUNCTION(BlueprintCallable, Category = "Cursory")
+	static void PreloadCursor(FGameplayTag Identifier);
+
+	/** 
+	 * Register the cursors of a registry at runtime (e.g. when a Game Feature activates), and load them in the background.
+	 * Returns false if the registry is already registered.
+	 */
 	UFUNCTION(BlueprintCallable, Category = "Cursory")
-	static void ResetCursorStack();
+	static bool RegisterCursorSet(const UCursoryRegistry* Registry);
+
+	/** Unregister the cursors of a registry, freeing their platform handles. */
+	UFUNCTION(BlueprintCallable, Category = "Cursory")
+	static void UnregisterCursorSet(const UCursoryRegistry* Registry);
+
+	/** Gets the Slate user index (used to select a cursor stack) for a local player. */
+	UFUNCTION(BlueprintPure, Category = "Cursory")
+	static int32 GetCursorUserIndex(APlayerController* Player);
 
 	/** Conforms the specified SWidget to use the global Cursory cursor. */
-	static void ConformSWidgetToCursory(SWidget* Widget);
+	static void ConformSWidgetToCursory(SWidget* Widget, int32 UserIndex = 0);
 
 	/** Conforms the specified widget to use the global Cursory cursor. */
-	UFUNCTION(BlueprintCallable, Category = "Cursory")
-	static void ConformWidgetToCursory(UWidget* Widget);
+	UFUNCTION(BlueprintCallable, Category = "Cursory", meta=(AdvancedDisplay="UserIndex"))
+	static void ConformWidgetToCursory(UWidget* Widget, int32 UserIndex = 0);
 
 	/** Conforms the specified widgets to use the global Cursory cursor. */
-	UFUNCTION(BlueprintCallable, Category = "Cursory")
-	static void ConformWidgetsToCursory(TArray<UWidget*> Widgets);
+	UFUNCTION(BlueprintCallable, Category = "Cursory", meta=(AdvancedDisplay="UserIndex"))
+	static void ConformWidgetsToCursory(TArray<UWidget*> Widgets, int32 UserIndex = 0);
 
 	/** 
 	 * Conforms the specified widget and all children 
@@ -90,7 +141,7 @@ public:
 	 * to use the global Cursory cursor. 
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Cursory", meta=(AdvancedDisplay=1, DisplayName="Conform Widget to Cursory (Recursive)"))
-	static void ConformWidgetToCursoryRecursive(UUserWidget* Widget, bool bDescendantUserWidgets = false);
+	static void ConformWidgetToCursoryRecursive(UUserWidget* Widget, bool bDescendantUserWidgets = false, int32 UserIndex = 0);
 
 	/** Pause automatically focusing viewport when directly hovered. */
 	UFUNCTION(BlueprintCallable, Category = "Cursory")
@@ -99,4 +150,16 @@ public:
 	/** Resume automatically focusing viewport when directly hovered. */
 	UFUNCTION(BlueprintCallable, Category = "Cursory")
 	static void ResumeAutoFocusViewport();
+
+	/** Enable or disable driving the hardware cursor with a gamepad stick. */
+	UFUNCTION(BlueprintCallable, Category = "Cursory|Gamepad")
+	static void SetGamepadCursorEnabled(bool bEnabled);
+
+	/** Add a widget that attracts (and snaps) the gamepad-driven cursor. */
+	UFUNCTION(BlueprintCallable, Category = "Cursory|Gamepad")
+	static void AddGamepadCursorTarget(UWidget* Widget);
+
+	/** Remove a widget that attracts the gamepad-driven cursor. */
+	UFUNCTION(BlueprintCallable, Category = "Cursory|Gamepad")
+	static void RemoveGamepadCursorTarget(UWidget* Widget);
 };
\ No newline at end of file
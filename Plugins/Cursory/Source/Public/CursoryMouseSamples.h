@@ -0,0 +1,139 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/** A single mouse move or button press, as received from the platform. */
+struct FCursoryMouseSample
+{
+	/** Time the move was processed (FPlatformTime::Seconds). */
+	double Time{0.0};
+
+	/** Cursor position, in screen space. */
+	FVector2D ScreenPosition{FVector2D::ZeroVector};
+
+	/** Movement since the previous move, in screen space. */
+	FVector2D Delta{FVector2D::ZeroVector};
+
+	/** Slate user that moved. */
+	int32 UserIndex{0};
+
+	/** True if this sample is a button press rather than a move (in which case Delta is zero). */
+	bool bPressed{false};
+};
+
+/**
+ * Fixed-capacity ring of mouse samples, written by a single producer (Slate input processing)
+ * and read by any number of FCursoryMouseSampleReaders without copying.
+ * The write position is published atomically, so recording a sample never blocks or allocates.
+ */
+class CURSORY_API FCursoryMouseSampleBuffer
+{
+public:
+
+	/** Capacity in samples. Kept a power of two so positions wrap with a mask. */
+	static constexpr uint64 Capacity = 1024;
+
+	FCursoryMouseSampleBuffer();
+
+	/** Appends a sample, overwriting the oldest one once full. Producer only. */
+	void Record(const FCursoryMouseSample& Sample);
+
+	/** Gets the total number of samples ever recorded (i.e. the position of the next write). */
+	uint64 GetWritePosition() const
+	{
+		return WritePosition.load(std::memory_order_acquire);
+	}
+
+	/** Gets the sample at an absolute position. The position must be within Capacity of the write position. */
+	const FCursoryMouseSample& GetSample(uint64 Position) const
+	{
+		return Samples[Position & (Capacity - 1)];
+	}
+
+private:
+
+	TArray<FCursoryMouseSample> Samples;
+	std::atomic<uint64> WritePosition{0};
+};
+
+/**
+ * Samples returned by a read. Since the ring may wrap, they come as (up to) two contiguous spans,
+ * oldest first. Views point straight into the ring, and stay valid until samples are next recorded
+ * (i.e. for the rest of the frame, when read on the game thread).
+ */
+struct FCursoryMouseSampleSpan
+{
+	TArrayView<const FCursoryMouseSample> First;
+	TArrayView<const FCursoryMouseSample> Second;
+
+	int32 Num() const
+	{
+		return First.Num() + Second.Num();
+	}
+
+	template<typename FunctorType>
+	void ForEach(FunctorType&& Functor) const
+	{
+		for (const FCursoryMouseSample& Sample : First)
+		{
+			Functor(Sample);
+		}
+
+		for (const FCursoryMouseSample& Sample : Second)
+		{
+			Functor(Sample);
+		}
+	}
+};
+
+/**
+ * Reads mouse samples from the shared buffer at its own pace.
+ * Each reader tracks its own position, so any number of systems can consume
+ * every sample from a single input listener.
+ * Create with UCursorySystem::CreateMouseSampleReader. Read on the game thread.
+ */
+class CURSORY_API FCursoryMouseSampleReader
+{
+public:
+
+	FCursoryMouseSampleReader() = default;
+	explicit FCursoryMouseSampleReader(TSharedRef<const FCursoryMouseSampleBuffer> InBuffer);
+
+	/**
+	 * Gets the samples recorded since the previous read, and advances past them.
+	 * If more than Capacity samples were recorded in between, the oldest are skipped (see GetDroppedCount).
+	 */
+	FCursoryMouseSampleSpan Read();
+
+	/** Gets the samples recorded since the previous read, without advancing. */
+	FCursoryMouseSampleSpan Peek() const;
+
+	/** Skips all samples recorded so far. */
+	void SkipToLatest();
+
+	/** Number of samples this reader missed by falling behind. */
+	uint64 GetDroppedCount() const
+	{
+		return DroppedCount;
+	}
+
+	bool IsValid() const
+	{
+		return Buffer.IsValid();
+	}
+
+private:
+
+	/** Gets the spans between the (clamped) read position and the write position. */
+	FCursoryMouseSampleSpan MakeSpan(uint64 Begin, uint64 End) const;
+
+	TSharedPtr<const FCursoryMouseSampleBuffer> Buffer;
+
+	/** Absolute position of the next sample to read. */
+	uint64 ReadPosition{0};
+
+	uint64 DroppedCount{0};
+};
@@ -0,0 +1,54 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "CursoryTypes.h"
+#include "CursoryRegistry.generated.h"
+
+struct FAssetData;
+
+/**
+ * A set of custom cursor specs, kept in an asset rather than in config.
+ * Specs only reference their images by path, so loading a registry does not load any cursor art.
+ *
+ * Registries are discovered through the Asset Registry without being loaded:
+ * each one records its identifiers and highest load priority as asset tags.
+ * Registries with Critical cursors are loaded on startup, those with Normal cursors in the background,
+ * and those with only Deferred cursors not until one of their cursors is requested.
+ * Cursors listed in the project settings take precedence over registry cursors with the same identifier.
+ * Registries marked bRegisterAtRuntime are skipped, and left to UCursorySystem::RegisterCursorSet.
+ *
+ * To have registries cooked, add the CursoryRegistry type to the Asset Manager's Primary Asset Types to Scan.
+ */
+UCLASS(BlueprintType)
+class CURSORY_API UCursoryRegistry : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Custom cursor specs. */
+	UPROPERTY(EditAnywhere, Category = "Cursors", meta=(TitleProperty="Identifier"))
+	TArray<FCursorInfo> CursorSpecs;
+
+	/**
+	 * If true, the registry is not picked up on startup, and its cursors are only known once it is
+	 * registered with UCursorySystem::RegisterCursorSet (e.g. by a Game Feature plugin), and freed once unregistered.
+	 * Its cursors are not given compact cursor ids.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Cursors")
+	bool bRegisterAtRuntime{false};
+
+	/** Finds all registries known to the Asset Registry that are picked up on startup, without loading them. */
+	static void FindRegistries(TArray<FAssetData>& OutRegistries);
+
+	/** Reads the identifiers a registry defines from its asset tags. */
+	static TArray<FGameplayTag> GetIdentifiers(const FAssetData& Registry);
+
+	/** Reads the highest load priority among a registry's cursors from its asset tags. */
+	static ECursorLoadPriority GetLoadPriority(const FAssetData& Registry);
+
+	void GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const override;
+};
@@ -0,0 +1,159 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GenericPlatform/ICursor.h"
+#include "GameplayTagContainer.h"
+#include "CursoryReplicatedCursorComponent.generated.h"
+
+class APlayerController;
+
+/**
+ * A normalized viewport position, quantized to 16 bits per axis.
+ */
+USTRUCT()
+struct FCursoryQuantizedPosition
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	uint16 X{0};
+
+	UPROPERTY()
+	uint16 Y{0};
+
+	/** Quantizes a normalized position (clamped to 0..1). */
+	static FCursoryQuantizedPosition Quantize(const FVector2D& Normalized);
+
+	/** Gets the normalized position. */
+	FVector2D Dequantize() const;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FCursoryQuantizedPosition& Other) const
+	{
+		return X == Other.X && Y == Other.Y;
+	}
+
+	bool operator!=(const FCursoryQuantizedPosition& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FCursoryQuantizedPosition> : public TStructOpsTypeTraitsBase2<FCursoryQuantizedPosition>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
+/**
+ * Add this to a PlayerState (or Pawn) to share its player's cursor with other players,
+ * e.g. for co-op "ping" pointers.
+ * The owning player's current cursor (as a compact id) and normalized viewport position
+ * are sent to the server, which replicates them to everyone else.
+ * - The cursor id is sent reliably, only when it changes.
+ * - The position is sent unreliably, only when it changes, and at most SendRate times per second.
+ *   Once the cursor has rested for SettleDelay, its position is sent once more reliably, in case the last update was lost.
+ * Remote players see the position interpolated between updates.
+ * Works with a listen server, including in PIE.
+ */
+UCLASS(meta=(BlueprintSpawnableComponent = true))
+class CURSORY_API UCursoryReplicatedCursorComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UCursoryReplicatedCursorComponent();
+
+	/** Gets the player's cursor type. */
+	UFUNCTION(BlueprintPure, Category = "Cursory|Network")
+	TEnumAsByte<EMouseCursor::Type> GetCursorType() const;
+
+	/** Gets the player's custom cursor identifier (if the cursor type is Custom). */
+	UFUNCTION(BlueprintPure, Category = "Cursory|Network")
+	FGameplayTag GetCustomCursorIdentifier() const;
+
+	/** Gets the player's (interpolated) cursor position, normalized to their viewport. */
+	UFUNCTION(BlueprintPure, Category = "Cursory|Network")
+	FVector2D GetCursorPosition() const;
+
+	/** Whether any cursor state has been received for this player yet. */
+	UFUNCTION(BlueprintPure, Category = "Cursory|Network")
+	bool HasCursorState() const;
+
+	/** Maximum position updates sent per second. */
+	UPROPERTY(EditAnywhere, Category = "Cursory", meta=(ClampMin="1"))
+	float SendRate{15.0f};
+
+	/** Time (in seconds) the cursor has to rest before its position is sent reliably. */
+	UPROPERTY(EditAnywhere, Category = "Cursory", meta=(ClampMin="0"))
+	float SettleDelay{0.25f};
+
+private:
+
+	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Gets the player controller whose cursor is shared. */
+	APlayerController* GetOwningController() const;
+
+	/** Samples the local player's cursor, and sends it if it changed. */
+	void SendLocalCursor(APlayerController* Player, float DeltaTime);
+
+	/** Advances interpolation toward the last received position. */
+	void InterpolateRemoteCursor(float DeltaTime);
+
+	UFUNCTION(Server, Reliable)
+	void ServerSetCursorId(uint16 CursorId);
+
+	UFUNCTION(Server, Unreliable)
+	void ServerSetPosition(FCursoryQuantizedPosition Position);
+
+	/** Sends the position the cursor came to rest at. */
+	UFUNCTION(Server, Reliable)
+	void ServerSetSettledPosition(FCursoryQuantizedPosition Position);
+
+	UFUNCTION()
+	void OnRep_CursorId();
+
+	UFUNCTION()
+	void OnRep_Position();
+
+	/** Compact id of the player's cursor (see UCursorySystem::GetCompactCursorId). */
+	UPROPERTY(ReplicatedUsing = OnRep_CursorId)
+	uint16 ReplicatedCursorId;
+
+	/** Normalized, quantized viewport position of the player's cursor. */
+	UPROPERTY(ReplicatedUsing = OnRep_Position)
+	FCursoryQuantizedPosition ReplicatedPosition;
+
+	/** Resolved cursor. */
+	TEnumAsByte<EMouseCursor::Type> CursorType{EMouseCursor::Default};
+	FGameplayTag CustomCursorIdentifier;
+
+	/** Interpolated position. */
+	FVector2D DisplayedPosition{FVector2D::ZeroVector};
+	FVector2D InterpolationStart{FVector2D::ZeroVector};
+	FVector2D InterpolationTarget{FVector2D::ZeroVector};
+	float InterpolationAlpha{1.0f};
+
+	/** Last state sent by the owning player. */
+	uint16 LastSentCursorId;
+	FCursoryQuantizedPosition LastSentPosition;
+	float TimeSinceLastSend{0.0f};
+
+	/** Whether the last sent position has been sent reliably since the cursor came to rest. */
+	bool bSentSettledPosition{true};
+
+	bool bHasCursorState{false};
+};
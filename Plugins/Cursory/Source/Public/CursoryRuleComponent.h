@@ -0,0 +1,61 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CursoryTypes.h"
+#include "CursoryRuleSet.h"
+#include "CursoryRuleComponent.generated.h"
+
+/**
+ * Add this to a PlayerController to drive its cursor from a rule set,
+ * instead of pushing and removing cursors from Blueprint every frame.
+ * Inputs are sampled on tick, but rules are only evaluated when an input changes.
+ * The result is written to a single stack element owned by this component,
+ * which is removed when no rule matches.
+ */
+UCLASS(meta=(BlueprintSpawnableComponent = true))
+class CURSORY_API UCursoryRuleComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UCursoryRuleComponent();
+
+	/** Swaps the rule set, and evaluates it right away. */
+	UFUNCTION(BlueprintCallable, Category = "Cursory")
+	void SetRuleSet(UCursoryRuleSet* InRuleSet);
+
+	/** Rules that drive the cursor. */
+	UPROPERTY(EditAnywhere, Category = "Cursory")
+	UCursoryRuleSet* RuleSet;
+
+private:
+
+	void Activate(bool bReset) override;
+	void Deactivate() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Samples the rule inputs, and applies the matching rule if any input changed since the last evaluation. */
+	void UpdateCursor();
+
+	/** Writes the matching rule's cursor to the managed stack element. */
+	void ApplyRule(const FCursoryRule* Rule);
+
+	/** Removes the managed stack element. */
+	void ReleaseCursor();
+
+	/** Handle of the managed stack element. */
+	FCursorStackElementHandle Handle;
+
+	/** Cursor currently written to the managed stack element. */
+	FCursorStackElement AppliedCursor;
+
+	/** Inputs the rules were last evaluated with. */
+	FCursoryRuleInputs LastInputs;
+
+	bool bEvaluated{false};
+};
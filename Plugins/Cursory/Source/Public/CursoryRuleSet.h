@@ -0,0 +1,201 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GenericPlatform/ICursor.h"
+#include "GameplayTagContainer.h"
+#include "CursoryRuleSet.generated.h"
+
+class APlayerController;
+class AActor;
+class UUserWidget;
+
+/** Modifier keys that cursor rules can test. */
+UENUM(meta=(Bitflags, UseEnumValuesAsMaskValuesInEditor="true"))
+enum class ECursoryModifierKey : uint8
+{
+	None = 0 UMETA(Hidden),
+	Shift = 1 << 0,
+	Control = 1 << 1,
+	Alt = 1 << 2,
+	Command = 1 << 3
+};
+ENUM_CLASS_FLAGS(ECursoryModifierKey);
+
+/** Input mode that cursor rules can test. */
+UENUM(BlueprintType)
+enum class ECursoryInputMode : uint8
+{
+	Any,
+	GameOnly,
+	UIOnly,
+	GameAndUI
+};
+
+/**
+ * Maps a set of conditions to a cursor.
+ * Every condition that is set must hold for the rule to match.
+ */
+USTRUCT(BlueprintType)
+struct FCursoryRule
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Modifier keys that must be held. */
+	UPROPERTY(EditAnywhere, Category = Conditions, meta=(Bitmask, BitmaskEnum="ECursoryModifierKey"))
+	int32 RequiredModifiers{0};
+
+	/** Modifier keys that must not be held. */
+	UPROPERTY(EditAnywhere, Category = Conditions, meta=(Bitmask, BitmaskEnum="ECursoryModifierKey"))
+	int32 ExcludedModifiers{0};
+
+	/** Input mode the player must be in. */
+	UPROPERTY(EditAnywhere, Category = Conditions)
+	ECursoryInputMode InputMode{ECursoryInputMode::Any};
+
+	/** Class the actor under the cursor must be (or derive from). Leave empty to ignore. */
+	UPROPERTY(EditAnywhere, Category = Conditions)
+	TSubclassOf<AActor> HoveredActorClass;
+
+	/** Class a user widget under the cursor must be (or derive from). Leave empty to ignore. */
+	UPROPERTY(EditAnywhere, Category = Conditions)
+	TSubclassOf<UUserWidget> HoveredWidgetClass;
+
+	/**
+	 * Tags the player must have. Tags are gathered from the pawn, player state
+	 * and player controller, wherever they implement IGameplayTagAssetInterface.
+	 */
+	UPROPERTY(EditAnywhere, Category = Conditions)
+	FGameplayTagContainer RequiredTags;
+
+	/** Tags the player must not have. */
+	UPROPERTY(EditAnywhere, Category = Conditions)
+	FGameplayTagContainer BlockedTags;
+
+	/** Cursor type used when the rule matches. */
+	UPROPERTY(EditAnywhere, Category = Cursor)
+	TEnumAsByte<EMouseCursor::Type> CursorType{EMouseCursor::Custom};
+
+	/** Custom cursor used when the rule matches (if the cursor type is Custom). */
+	UPROPERTY(EditAnywhere, Category = Cursor)
+	FGameplayTag CustomCursorIdentifier;
+};
+
+/**
+ * Inputs sampled for rule evaluation.
+ * Rules only need to be evaluated again when these change.
+ */
+struct FCursoryRuleInputs
+{
+	/** Held modifier keys (ECursoryModifierKey). */
+	uint8 Modifiers{0};
+
+	/** Current input mode, as a single bit. */
+	uint8 InputMode{0};
+
+	/** Predicates that hold, by compiled predicate index. */
+	uint64 Predicates{0};
+
+	bool operator==(const FCursoryRuleInputs& Other) const
+	{
+		return Modifiers == Other.Modifiers && InputMode == Other.InputMode && Predicates == Other.Predicates;
+	}
+
+	bool operator!=(const FCursoryRuleInputs& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+/**
+ * Data-driven cursor rules, e.g. "Shift held + hovering an enemy + targeting => Cursors.Attack.Queued".
+ * Rules are checked in order, and the first match wins.
+ *
+ * On load, rules are compiled into a flat table: each distinct class or tag condition
+ * becomes a predicate bit, so that matching a rule is a handful of mask tests.
+ * Use with a UCursoryRuleComponent.
+ */
+UCLASS(BlueprintType)
+class CURSORY_API UCursoryRuleSet : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Rules, in priority order. */
+	UPROPERTY(EditAnywhere, Category = "Rules")
+	TArray<FCursoryRule> Rules;
+
+	/** Compiles the rules into the decision table. Call again after changing rules at runtime. */
+	void Compile();
+
+	/** 
+	 * Compiles the rules if they have not been compiled yet (e.g. for rule sets created at runtime),
+	 * or if rules were added or removed since.
+	 */
+	void CompileIfStale();
+
+	/** Samples the inputs the rules depend on for a player. */
+	FCursoryRuleInputs GatherInputs(const APlayerController* Player, int32 UserIndex) const;
+
+	/** Finds the first rule that matches the inputs. Returns null if none match. */
+	const FCursoryRule* Evaluate(const FCursoryRuleInputs& Inputs) const;
+
+	void PostLoad() override;
+
+#if WITH_EDITOR
+	void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+
+	/** Condition that needs more than a bit test to check. */
+	struct FPredicate
+	{
+		enum class EKind : uint8
+		{
+			HoveredActor,
+			HoveredWidget,
+			Tags
+		};
+
+		EKind Kind;
+		const UClass* Class{nullptr};
+		FGameplayTagContainer RequiredTags;
+		FGameplayTagContainer BlockedTags;
+	};
+
+	/** A rule, reduced to masks. Kept small so the table stays cache-friendly. */
+	struct FCompiledRule
+	{
+		uint64 RequiredPredicates{0};
+		uint8 RequiredModifiers{0};
+		uint8 ExcludedModifiers{0};
+		uint8 InputModes{0};
+
+		/** Index into Rules. */
+		uint16 RuleIndex{0};
+	};
+
+	/** Finds or adds a predicate, returning its bit. Returns 0 if there are too many predicates. */
+	uint64 AddPredicate(const FPredicate& Predicate);
+
+	/** Compiled rules, in priority order. */
+	TArray<FCompiledRule> CompiledRules;
+
+	/** Distinct predicates, by bit index. */
+	TArray<FPredicate> Predicates;
+
+	/** Whether any predicate needs the actor under the cursor (which requires a trace). */
+	bool bNeedsHoveredActor{false};
+
+	/** Whether any predicate needs the widgets under the cursor. */
+	bool bNeedsHoveredWidgets{false};
+
+	/** Whether the rules have been compiled at least once. */
+	bool bCompiled{false};
+};
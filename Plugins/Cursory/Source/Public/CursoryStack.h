@@ -0,0 +1,85 @@
+//  2021 Mustafa Moiz. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CursoryTypes.h"
+
+/** A cursor on a stack, as stored natively. Plain data, so copying it is a memcpy. */
+struct FCursoryStackEntry
+{
+	FCursorStackElementHandle Handle;
+
+	EMouseCursor::Type CursorType{EMouseCursor::Default};
+
+	FGameplayTag CustomCursorIdentifier;
+};
+
+static_assert(TIsTriviallyDestructible<FCursoryStackEntry>::Value, "Cursor stack entries must stay plain data.");
+
+/**
+ * Native cursor stack, free of reflection and garbage collection.
+ * Entries are kept in an inline buffer, so stacks up to InlineDepth deep never touch the heap;
+ * removals never shrink it.
+ * The topmost entry (i.e. the last) dictates the cursor.
+ */
+class CURSORY_API FCursoryStack
+{
+public:
+
+	/** Depth up to which entries are stored inline. Deeper stacks spill to the heap. */
+	static constexpr int32 InlineDepth = 8;
+
+	/** Pushes a cursor in place. */
+	void Push(FCursorStackElementHandle Handle, EMouseCursor::Type CursorType, const FGameplayTag& CustomCursorIdentifier);
+
+	/** Removes the topmost cursor. */
+	void Pop();
+
+	/** Removes a cursor by handle, keeping the order of the rest. Returns false if not found. */
+	bool Remove(FCursorStackElementHandle Handle);
+
+	/** Removes every cursor above the bottommost NewNum. */
+	void Truncate(int32 NewNum);
+
+	FCursoryStackEntry* Find(FCursorStackElementHandle Handle);
+	const FCursoryStackEntry* Find(FCursorStackElementHandle Handle) const;
+
+	bool Contains(FCursorStackElementHandle Handle) const
+	{
+		return Find(Handle) != nullptr;
+	}
+
+	int32 Num() const
+	{
+		return Entries.Num();
+	}
+
+	/** Gets the topmost cursor. The stack must not be empty. */
+	const FCursoryStackEntry& Top() const
+	{
+		return Entries.Last();
+	}
+
+	/** Gets the bottommost cursor (i.e. a user's base cursor). The stack must not be empty. */
+	FCursoryStackEntry& Bottom()
+	{
+		return Entries[0];
+	}
+
+	/** Gets the cursors, bottommost first. */
+	TArrayView<const FCursoryStackEntry> GetEntries() const
+	{
+		return Entries;
+	}
+
+	/** Gets the memory the stack holds on the heap, which is zero while it fits inline. */
+	SIZE_T GetHeapSize() const
+	{
+		return Entries.GetAllocatedSize();
+	}
+
+private:
+
+	TArray<FCursoryStackEntry, TInlineAllocator<InlineDepth>> Entries;
+};
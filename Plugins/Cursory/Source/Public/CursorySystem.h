@@ -4,18 +4,112 @@
 
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
+#include "UObject/SoftObjectPath.h"
 #include "GameplayTagContainer.h"
+#include "Containers/Ticker.h"
 #include "CursoryTypes.h"
+#include "CursoryStack.h"
+#include "CursoryMouseSamples.h"
 #include "CursorySystem.generated.h"
 
 class APlayerController;
 class AGameModeBase;
+class UCursorySystem;
+class SWidget;
+class SWindow;
+class FCursoryGamepadCursor;
+class FCursoryMouseSampler;
+class FCursoryHeatmap;
+class UCursoryRegistry;
+class FCursoryScaler;
+struct FCursoryDecodedCursor;
+
+DECLARE_EVENT_TwoParams(UCursorySystem, FCursorChanged, EMouseCursor::Type /* Cursor */, EMouseCursor::Type /* OldCursor */);
+
+/** The net change of a user's cursor over a frame. */
+struct FCursoryCursorChange
+{
+	int32 UserIndex{0};
+
+	EMouseCursor::Type OldCursorType{EMouseCursor::None};
+	EMouseCursor::Type NewCursorType{EMouseCursor::None};
+
+	FGameplayTag OldCustomCursorIdentifier;
+	FGameplayTag NewCustomCursorIdentifier;
+
+	/**
+	 * Handle of the stack element acted on by the last change: the element pushed, modified, removed or popped
+	 * (for a reset, the topmost element removed). It may no longer be on the stack.
+	 */
+	FCursorStackElementHandle Cause;
+};
+
+/** Selects the cursor changes a subscriber is notified of. */
+struct CURSORY_API FCursoryCursorChangeFilter
+{
+	/** User to listen to, or INDEX_NONE for all users. */
+	int32 UserIndex{INDEX_NONE};
+
+	/** 
+	 * Custom cursors to listen to. A change matches if its old or new custom cursor matches any of these.
+	 * Leave empty to listen to all changes.
+	 */
+	FGameplayTagContainer Tags;
+
+	/** If true, tags must match exactly. Otherwise, child tags match too (e.g. Cursors.Attack matches Cursors.Attack.Queued). */
+	bool bExactMatch{false};
+
+	bool Matches(const FCursoryCursorChange& Change) const;
+};
+
+/** Counts of custom cursor mounts, to verify that redundant platform calls are avoided. */
+struct FCursoryMountStats
+{
+	/** Mounts that called into the platform (SetTypeShape). */
+	uint32 PlatformCalls{0};
+
+	/** Mounts skipped because the same cursor was still mounted (e.g. when toggling between a standard and a custom cursor). */
+	uint32 SkippedSameCursor{0};
+
+	/** Mounts skipped because a cursor with the same platform handle was mounted (e.g. tags that share art). */
+	uint32 SkippedSameHandle{0};
+};
+
+/** Receives the net cursor changes of a frame that passed the subscriber's filter. */
+DECLARE_DELEGATE_OneParam(FOnCursoryCursorChanges, TArrayView<const FCursoryCursorChange> /* Changes */);
+
+/**
+ * Cursor state owned by a single local user (i.e. Slate user).
+ * Each user has its own stack, evaluated independently of other users.
+ * Kept native (not reflected), since it holds no objects and changes on every push and pop.
+ */
+struct FCursoryUserState
+{
+	/** Cursor stack - topmost element dictates current cursor. */
+	FCursoryStack CursorStack;
+
+	/** Cached cursor type. */
+	EMouseCursor::Type CachedCursorType{EMouseCursor::None};
+
+	/** Cached custom cursor identifier. */
+	FGameplayTag CachedCustomCursorIdentifier;
+
+	/** Delegate for when this user's cursor type changes. */
+	FCursorChanged CursorTypeChanged;
+
+	/** Change accumulated since the last dispatch, if any. */
+	TOptional<FCursoryCursorChange> PendingChange;
+};
 
 /**
  * Main interface for manipulating hardware cursors.
  * Loads cursors on Engine init and allows user to
  * use cursors at runtime. Loaded cursors are handled by the underlying platform, 
  * and do not need to be unloaded or deleted manually.
+ *
+ * Each local user (identified by Slate user index) has its own cursor stack.
+ * Functions that do not specify a user operate on the primary user (0).
+ * Stacks are stored natively (see FCursoryStack); stack elements are only the reflected form used by callers.
  */
 UCLASS()
 class CURSORY_API UCursorySystem : public UObject
@@ -29,12 +123,12 @@ public:
 	 * listening for Engine events to start loading cursors. 
 	 */
 	void Init();
-	
-	/** Get the current cursor type. */
-	TOptional<EMouseCursor::Type> GetCurrentCursorType() const;
 
-	/** Get the current custom cursor identifier. */
-	FGameplayTag GetCurrentCustomCursorIdentifier() const;
+	/** Get the current cursor type for a user. */
+	TOptional<EMouseCursor::Type> GetCurrentCursorType(int32 UserIndex = 0) const;
+
+	/** Get the current custom cursor identifier for a user. */
+	FGameplayTag GetCurrentCustomCursorIdentifier(int32 UserIndex = 0) const;
 
 	/** Gets the number of loaded custom cursors. */
 	int32 GetCustomCursorCount() const;
@@ -42,42 +136,187 @@ public:
 	/** Gets the full list of cursor options. */
 	FGameplayTagContainer GetCustomCursorOptions() const;
 
+	/** Gets the load status of a custom cursor. */
+	ECursorLoadStatus GetCursorLoadStatus(FGameplayTag Identifier) const;
+
+	/** Starts loading a deferred cursor in the background, ahead of its first use. */
+	void RequestCursorLoad(FGameplayTag Identifier);
+
+	/**
+	 * Registers a set of custom cursors at runtime (e.g. when a Game Feature plugin activates),
+	 * and loads them in the background. Identifiers that are already defined are ignored.
+	 * Runtime sets are not given compact cursor ids, since they may differ between machines.
+	 * Returns false if a set with the same name is already registered.
+	 */
+	bool RegisterCursorSet(FName SetName, const TArray<FCursorInfo>& CursorSpecs);
+
+	/**
+	 * Registers the cursors of a registry asset as a set, named after the registry.
+	 * The registry should be marked bRegisterAtRuntime, or its cursors will already be defined on startup.
+	 */
+	bool RegisterCursorSet(const UCursoryRegistry* Registry);
+
+	/** Unregisters a cursor set, and frees the platform handles that no other cursor shares. */
+	void UnregisterCursorSet(FName SetName);
+
+	/** Whether a cursor set is registered. */
+	bool IsCursorSetRegistered(FName SetName) const;
+
+	/** 
+	 * Decodes and creates the cursors of a theme in the background,
+	 * so that switching to it later does not hitch.
+	 */
+	void PrewarmTheme(FName Theme);
+
+	/** 
+	 * Switches to a theme (NAME_None for the base cursors).
+	 * A theme that is not warm yet is pre-warmed first, and switched to once ready.
+	 * The current cursor is re-mounted once after the switch.
+	 */
+	void SetTheme(FName Theme);
+
+	/** Gets the active theme (NAME_None for the base cursors). */
+	FName GetTheme() const;
+
+	/** Whether a theme has been pre-warmed and can be switched to instantly. */
+	bool IsThemeReady(FName Theme) const;
+
+	/** 
+	 * Sets the cursor size multiplier (e.g. for accessibility), snapped to quarter steps.
+	 * Resized cursors are generated in the background and cached per size;
+	 * the current cursor is swapped once its resized version is ready.
+	 */
+	void SetCursorScale(float Scale);
+
+	/** Gets the cursor size multiplier. */
+	float GetCursorScale() const;
+
 	/** 
 	 * Mounts the specified cursor for the platform's MouseCursor::Custom. 
 	 * Cursor must be set to Custom to see the effect. 
+	 * Does not call into the platform if the cursor (or its platform handle) is already mounted.
 	 */
 	void MountCustomCursor(FGameplayTag& Identifier, bool bWidget = false);
 
-	/** Set base cursor. */
-	void ModifyBaseCursor(const FCursorStackElement& Cursor, bool bIgnoreType = false, bool bIgnoreCustom = false);
+	/** Gets counts of custom cursor mounts, and of those skipped as redundant. */
+	const FCursoryMountStats& GetMountStats() const;
+
+	/** Clears the custom cursor mount counts. */
+	void ResetMountStats();
+
+	/** Set base cursor for a user. */
+	void ModifyBaseCursor(const FCursorStackElement& Cursor, bool bIgnoreType = false, bool bIgnoreCustom = false, int32 UserIndex = 0);
 
-	/** Push a cursor onto the stack. */
-	FCursorStackElementHandle PushCursor(FCursorStackElement Cursor);
+	/** Push a cursor onto a user's stack. */
+	FCursorStackElementHandle PushCursor(const FCursorStackElement& Cursor, int32 UserIndex = 0);
 
-	/** Modify a cursor on the stack by handle. */
-	void ModifyCursorByHandle(FCursorStackElementHandle Handle, FCursorStackElement NewCursor);
+	/** Modify a cursor on any user's stack by handle. */
+	void ModifyCursorByHandle(FCursorStackElementHandle Handle, const FCursorStackElement& NewCursor);
 
-	/** Remove a cursor from the stack by handle. */
+	/** Remove a cursor from any user's stack by handle. */
 	void RemoveCursorByHandle(FCursorStackElementHandle Handle);
 
-	/** Pop a cursor from the stack. */
-	void PopCursor();
+	/** Pop a cursor from a user's stack. */
+	void PopCursor(int32 UserIndex = 0);
 
-	/** Reset cursor stack (clear all stack elements except base). */
-	void ResetCursorStack();
+	/** Reset a user's cursor stack (clear all stack elements except base). */
+	void ResetCursorStack(int32 UserIndex = 0);
+
+	/** 
+	 * Push a cursor onto a window's own stack (e.g. an editor utility window, or a game window on a second monitor).
+	 * While a window with a stack is hovered, its topmost cursor is used instead of the cursor user's;
+	 * custom cursors are only mounted as the mouse moves between windows that show different cursors.
+	 * The cursor applies wherever the window's widgets do not specify their own.
+	 * Remove and modify window cursors by handle, as with user cursors. A window's stack is dropped once empty.
+	 */
+	FCursorStackElementHandle PushWindowCursor(const TSharedRef<SWindow>& Window, const FCursorStackElement& Cursor);
+
+	/** Clear a window's cursor stack, returning the window to the cursor user's cursor. */
+	void ResetWindowCursorStack(const TSharedRef<SWindow>& Window);
+
+	/** Get the current cursor type of a window. Unset if the window has no cursor stack. */
+	TOptional<EMouseCursor::Type> GetWindowCursorType(TWeakPtr<SWindow> Window) const;
 
 	/** Set auto focus viewport. */
 	void SetAutoFocusViewport(bool bActive);
 
-	DECLARE_EVENT_TwoParams(UCursorySystem, FCursorChanged, EMouseCursor::Type /* Cursor */, EMouseCursor::Type /* OldCursor */);
+	/** Enable or disable driving the hardware cursor with a gamepad stick. */
+	void SetGamepadCursorEnabled(bool bEnabled);
 
-	/** Delegate for when cursor type changes. */
-	FCursorChanged CursorTypeChanged;
+	/** Whether the hardware cursor can currently be driven with a gamepad stick. */
+	bool IsGamepadCursorEnabled() const;
+
+	/** Add a widget that attracts (and snaps) the gamepad-driven cursor. */
+	void AddGamepadCursorTarget(const TSharedRef<SWidget>& Widget);
+
+	/** Remove a widget that attracts the gamepad-driven cursor. */
+	void RemoveGamepadCursorTarget(const TSharedRef<SWidget>& Widget);
+
+	/**
+	 * Creates a reader of raw mouse moves and presses, recorded as Slate processes them (i.e. at the device rate, not the frame rate).
+	 * All readers share a single input listener and sample buffer, which is started on first use
+	 * and stopped once the last reader is destroyed.
+	 * The reader starts at the latest sample.
+	 */
+	FCursoryMouseSampleReader CreateMouseSampleReader();
+
+	/** 
+	 * Start or stop capturing a heatmap of where the cursor moves and clicks, per cursor.
+	 * Stopping saves the heatmap.
+	 */
+	void SetHeatmapCaptureEnabled(bool bEnabled);
+
+	/** Whether a cursor heatmap is being captured. */
+	bool IsHeatmapCaptureEnabled() const;
+
+	/** Saves the cursor heatmap captured so far, in the background. */
+	void FlushHeatmap();
+
+	/** Delegate for when a user's cursor type changes. */
+	FCursorChanged& OnCursorTypeChanged(int32 UserIndex = 0);
+
+	/** 
+	 * Subscribes to cursor changes (type or custom cursor) that pass a filter.
+	 * Changes are batched, so the delegate is called at most once per frame,
+	 * with the net change of each user (changes that revert within the frame are dropped).
+	 */
+	FDelegateHandle SubscribeToCursorChanges(const FCursoryCursorChangeFilter& Filter, FOnCursoryCursorChanges Delegate);
+
+	/** Removes a subscription made with SubscribeToCursorChanges. */
+	void UnsubscribeFromCursorChanges(FDelegateHandle Handle);
+
+	/** 
+	 * Gets a compact id for a cursor, suitable for replication.
+	 * Standard cursor types come first, followed by custom cursors sorted by tag,
+	 * so ids match across machines that share the same cursor specs.
+	 * Returns InvalidCompactCursorId for unknown custom cursors.
+	 */
+	uint16 GetCompactCursorId(EMouseCursor::Type CursorType, const FGameplayTag& Identifier) const;
+
+	/** Resolves a compact cursor id. Returns false if the id is unknown. */
+	bool ResolveCompactCursorId(uint16 CompactId, EMouseCursor::Type& OutCursorType, FGameplayTag& OutIdentifier) const;
+
+	/** Compact id that does not map to any cursor. */
+	static constexpr uint16 InvalidCompactCursorId = MAX_uint16;
+
+	/** 
+	 * Gets the Slate user index driven by the specified player.
+	 * Falls back to the primary user (0) if the player is not local.
+	 */
+	static int32 GetUserIndexForPlayer(const APlayerController* Player);
+
+	/** Maximum number of local users that may own a cursor stack. */
+	static constexpr int32 MaxUsers = 8;
 
 private:
 
+	/** Inspects internal state for debug commands and the debug overlay. */
+	friend class FCursoryDebug;
+
 	/** 
-	 * Loads all specified cursors on Engine startup. 
+	 * Loads all specified cursors on Engine startup, according to their load priority.
+	 * Cursors come from the project settings and from cursor registries.
+	 * Critical cursors are loaded before returning; the rest are loaded in the background.
 	 * Load priority:
 	 * - Windows: .ani -> .cur -> .png
 	 * - Mac: .tiff -> .png 
@@ -85,19 +324,146 @@ private:
 	 */
 	void LoadCustomCursors();
 
-	/** Pushes the base cursor onto the stack. */
-	void PushBaseCursor();
+	/** Loads base cursor specs according to their load priority. */
+	void AddBaseCursorSpecs(TArrayView<const FCursorInfo> CustomCursorSpecs);
 
-	/** Evaluates cursor stack. */
-	void EvaluateCursorStack();
+	/** 
+	 * Discovers cursor registries through the Asset Registry, and loads them according to their highest load priority.
+	 * Registries with only deferred cursors are left unloaded until needed.
+	 */
+	void ResolveCursorRegistries();
+
+	/** Loads the base cursor specs of a registry that are not defined elsewhere. */
+	void AddRegistryCursorSpecs(const UCursoryRegistry& Registry);
+
+	/** Loads a registry in the background, then its cursors (and the requested one, if any). */
+	void LoadCursorRegistry(const FSoftObjectPath& RegistryPath, FGameplayTag RequestedIdentifier);
+
+	/** Starts the idle loader if any deferred cursors or registries are waiting. */
+	void ScheduleIdleLoads();
+
+	/** Loads the cursors of a registered set in the background. */
+	void LoadCursorSet(FName SetName);
+
+	/** 
+	 * Decodes cursors on the thread pool, then creates their handles on the game thread.
+	 * OnLoaded receives the handles that were created successfully.
+	 * Discarded if cursors are reloaded in the meantime.
+	 */
+	void LoadCursorsAsync(TArray<FCursorInfo>&& Specs, TUniqueFunction<void(TMap<FGameplayTag, void*>&&)>&& OnLoaded);
+
+	/** Loads base cursors in the background, tracking their load status. */
+	void LoadBaseCursorsAsync(TArray<FCursorInfo>&& Specs);
+
+	/** Loads deferred cursors one at a time while no other loads are in flight. */
+	bool LoadDeferredCursorsWhenIdle(float DeltaTime);
+
+	/** 
+	 * Gets the platform handle for a decoded cursor, creating it only if no cursor
+	 * with identical content has a handle yet. Returns null on failure.
+	 */
+	void* FindOrCreateCursorHandle(ICursor& PlatformCursor, FCursoryDecodedCursor&& Decoded);
+
+	/** Drops a reference to a platform handle, freeing it (and its resized copies) once unused. */
+	void ReleaseCursorHandle(void* Handle);
+
+	/** Logs (and updates stats for) how many cursors share each platform handle. */
+	void ReportCursorSharing() const;
+
+	/** Finds the handle for a custom cursor in the active theme, falling back to the base cursors. */
+	void* FindCursorHandle(const FGameplayTag& Identifier) const;
+
+	/** Stores the handles of a pre-warmed theme, and switches to it if requested. */
+	void InstallTheme(FName Theme, TMap<FGameplayTag, void*>&& Cursors);
+
+	/** Switches to a ready theme and re-mounts the current cursor. */
+	void ActivateTheme(FName Theme);
+
+	/** Re-mounts the cursor user's current custom cursor (e.g. after its handle changed). */
+	void RemountCurrentCursor();
+
+	/** Forgets the mounted cursor, so that the next mount reaches the platform (e.g. once its handle is freed). */
+	void ForgetMountedCursor();
+
+	/** Rebuilds the compact id table from the custom cursor specs and registries. */
+	void BuildCompactCursorIds();
+
+	/** Finds the state for a user, if it exists. */
+	const FCursoryUserState* FindUserState(int32 UserIndex) const;
+
+	/** 
+	 * Finds the state for a user, creating it (and any preceding users) if necessary.
+	 * Returns null if the user index is out of range.
+	 */
+	FCursoryUserState* FindOrAddUserState(int32 UserIndex);
+
+	/** Finds the user whose stack contains the specified handle, or INDEX_NONE. */
+	int32 FindUserForHandle(FCursorStackElementHandle Handle) const;
+
+	/** Gets the user that currently owns the hardware cursor. */
+	int32 GetCursorUserIndex() const;
+
+	/** A window with its own cursor stack. */
+	struct FWindowCursorContext
+	{
+		TWeakPtr<SWindow> Window;
+
+		/** Identifies the window, even once it has been destroyed. Never dereferenced. */
+		const SWindow* WindowKey{nullptr};
+
+		/** The window's own cursor before it was given a stack, restored once the context is dropped. */
+		TOptional<EMouseCursor::Type> PreviousCursor;
+
+		FCursoryStack CursorStack;
+	};
+
+	/** Finds the cursor context of a window, if it has one. */
+	FWindowCursorContext* FindWindowContext(const SWindow* Window);
+	const FWindowCursorContext* FindWindowContext(const SWindow* Window) const;
+
+	/** Finds the window context whose stack contains the specified handle, if any. */
+	FWindowCursorContext* FindWindowContextForHandle(FCursorStackElementHandle Handle);
+
+	/** Drops a window's cursor context, returning the window to its previous cursor and the cursor user's cursor. */
+	void RemoveWindowContext(const SWindow* Window);
+
+	/** Gets the custom cursor the hardware cursor should show: the active window's, or else the cursor user's. */
+	FGameplayTag GetActiveCustomCursorIdentifier() const;
+
+	/** Mounts the active custom cursor if it differs from the specified one (i.e. the one mounted before a change). */
+	void MountActiveCursorIfChanged(const FGameplayTag& OldIdentifier);
+
+	/** Switches to the stack of the hovered window, if it has one, or back to the cursor user's. */
+	void AuditHoveredWindow();
+
+	/** Pushes the base cursor onto a user's stack. */
+	void PushBaseCursor(int32 UserIndex);
+
+	/** Evaluates a user's cursor stack, after a change to the specified element (see FCursoryCursorChange::Cause). */
+	void EvaluateCursorStack(int32 UserIndex, FCursorStackElementHandle Cause);
+
+	/** Records a change of custom cursor, and starts loading the cursors likely to follow it. */
+	void PrefetchLikelyCursors(const FGameplayTag& OldIdentifier, const FGameplayTag& NewIdentifier);
+
+	/** Clear all users' cursor stacks (all elements). */
+	void ClearCursorStacks();
+
+	/** Records a change to a user's cursor, to be dispatched at the end of the frame. */
+	void QueueCursorChange(int32 UserIndex, EMouseCursor::Type OldCursorType, const FGameplayTag& OldCustomCursorIdentifier, FCursorStackElementHandle Cause);
+
+	/** Notifies subscribers of the net cursor changes of the frame. */
+	bool DispatchCursorChanges(float DeltaTime);
+
+	/** Removes unbound subscriptions and adds those made while dispatching, and stops tracking changes if none are left. */
+	void CompactCursorChangeSubscriptions();
 
-	/** Clear cursor stack (all elements). */
-	void ClearCursorStack();
-	
 	/** Monitor viewport status. */
 	void MonitorViewportStatus();
 
-	/**
+	/** Unregisters the mouse sampler if its readers are all gone, or regardless if bForce. */
+	void ReleaseMouseSampler(bool bForce);
+
+	/** 
 	 * Check viewport status (i.e. whether it is hovered, focused, etc.)
 	 * to determine if we need to give focus to viewport or revert cursor
 	 * to the one tied to the player.
@@ -105,20 +471,136 @@ private:
 	 */
 	void AuditViewportStatus(float DeltaSeconds);
 
-	/** Loaded custom cursors. */
-	TMap<FGameplayTag, void*> LoadedCustomCursors;
-	
-	/** Cursor stack - topmost element dictates current cursor. */
-	UPROPERTY()
-	TArray<FCursorStackElement> CursorStack;
+	/** 
+	 * Loaded custom cursors, per theme (NAME_None for the base cursors).
+	 * Themes only hold the cursors they override.
+	 */
+	TMap<FName, TMap<FGameplayTag, void*>> LoadedCustomCursors;
 
-	/** Cached cursor type. */
-	UPROPERTY()
-	TEnumAsByte<EMouseCursor::Type> CachedCursorType;
+	/** Theme whose cursors are currently in use. */
+	FName ActiveTheme;
 
-	/** Cached custom cursor identifier. */
-	UPROPERTY()
-	FGameplayTag CachedCustomCursorIdentifier;
+	/** Theme to switch to once it has finished pre-warming. */
+	FName PendingTheme;
+
+	/** Themes currently being pre-warmed. */
+	TSet<FName> WarmingThemes;
+
+	/** Incremented whenever cursors are reloaded, to discard stale background work. */
+	int32 LoadGeneration{0};
+
+	/** Load status of each base cursor. */
+	TMap<FGameplayTag, ECursorLoadStatus> LoadStatuses;
+
+	/** Deferred cursors that have not been requested yet, in load order. */
+	TArray<FCursorInfo> DeferredSpecs;
+
+	/** Number of background loads of base cursors in flight. */
+	int32 PendingLoads{0};
+
+	/** Ticker that loads deferred cursors when idle. */
+	FTSTicker::FDelegateHandle IdleLoadHandle;
+
+	/** Registry that defines each registry cursor. */
+	TMap<FGameplayTag, FSoftObjectPath> RegistryCursors;
+
+	/** Registries with only deferred cursors, not loaded yet. */
+	TSet<FSoftObjectPath> UnloadedRegistries;
+
+	/** Pending wait for the Asset Registry's initial scan. */
+	FDelegateHandle AssetRegistryScanHandle;
+
+	/** Platform handles, by content key, so that identical cursors share one handle. */
+	TMap<FString, void*> HandlesByContent;
+
+	/** Number of cursors (identifiers, across themes) given a handle since the last reload. */
+	int32 LoadedCursorCount{0};
+
+	/** Number of platform handles created since the last reload. */
+	int32 UniqueHandleCount{0};
+
+	/** Number of cursors (identifiers, across themes) using each platform handle. */
+	TMap<void*, int32> HandleReferences;
+
+	/** A set of cursors registered at runtime. */
+	struct FCursorSet
+	{
+		TArray<FCursorInfo> CursorSpecs;
+
+		/** Identifiers this set defines (i.e. that were not already defined elsewhere). */
+		TArray<FGameplayTag> Identifiers;
+
+		/** Identifies the latest load of this set, to discard loads that finish after unregistering. */
+		int32 Serial{0};
+	};
+
+	/** Cursor sets registered at runtime, by name. */
+	TMap<FName, FCursorSet> CursorSets;
+
+	/** Source of cursor set load serials. */
+	int32 CursorSetSerial{0};
+
+	/** Custom cursor last mounted, if its handle is still mounted. */
+	FGameplayTag MountedCursorIdentifier;
+
+	/** Platform handle (as resized) set for MouseCursor::Custom, if any. */
+	void* MountedCursorHandle{nullptr};
+
+	/** Counts of custom cursor mounts. */
+	FCursoryMountStats MountStats;
+
+	/** Custom cursor identifiers, in compact id order. */
+	TArray<FGameplayTag> CompactCursorIds;
+
+	/** Compact ids by custom cursor identifier, as they are looked up every tick by replicated cursors. */
+	TMap<FGameplayTag, uint16> CompactCursorIdsByIdentifier;
+
+	/** Per-user cursor state, indexed by Slate user index. */
+	TArray<FCursoryUserState> UserStates;
+
+	/** Windows with their own cursor stacks. */
+	TArray<FWindowCursorContext> WindowContexts;
+
+	/** Window whose stack is in use, or null for the cursor user's stack. Only used for identity. */
+	const SWindow* ActiveWindow{nullptr};
 
 	TOptional<bool> bAutoFocusViewport;
+
+	/** Input processor that drives the hardware cursor from a gamepad. */
+	TSharedPtr<FCursoryGamepadCursor> GamepadCursor;
+
+	/** Generates and caches resized cursors. */
+	TSharedPtr<FCursoryScaler> Scaler;
+
+	/** Whether the gamepad cursor is registered with Slate. */
+	bool bGamepadCursorRegistered{false};
+
+	/** Input processor that records mouse moves for sample readers. Registered while any reader exists. */
+	TSharedPtr<FCursoryMouseSampler> MouseSampler;
+
+	/** Heatmap being captured, if any. */
+	TSharedPtr<FCursoryHeatmap> Heatmap;
+
+	/** A subscription to cursor changes. */
+	struct FCursorChangeSubscription
+	{
+		FDelegateHandle Handle;
+		FCursoryCursorChangeFilter Filter;
+		FOnCursoryCursorChanges Delegate;
+	};
+
+	/** Subscriptions to cursor changes. */
+	TArray<FCursorChangeSubscription> CursorChangeSubscriptions;
+
+	/** Subscriptions made while dispatching, added to CursorChangeSubscriptions once dispatch is done. */
+	TArray<FCursorChangeSubscription> AddedCursorChangeSubscriptions;
+
+	/**
+	 * Whether cursor changes are being dispatched.
+	 * Subscriptions removed meanwhile are only unbound, and compacted once dispatch is done.
+	 */
+	bool bDispatchingCursorChanges{false};
+
+	/** Ticker that dispatches queued cursor changes. Registered while there are subscriptions, rather than per change. */
+	FTSTicker::FDelegateHandle DispatchChangesHandle;
 };
\ No newline at end of file
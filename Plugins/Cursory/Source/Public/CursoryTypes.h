@@ -7,6 +7,33 @@
 #include "GameplayTagContainer.h"
 #include "CursoryTypes.generated.h"
 
+/** When a custom cursor is loaded. */
+UENUM(BlueprintType)
+enum class ECursorLoadPriority : uint8
+{
+	/** Loaded synchronously on Engine init, before the first frame. */
+	Critical,
+
+	/** Loaded in the background right after Engine init. */
+	Normal,
+
+	/** Loaded on first use, or in the background when nothing else is loading. */
+	Deferred
+};
+
+/** Load status of a custom cursor. */
+UENUM(BlueprintType)
+enum class ECursorLoadStatus : uint8
+{
+	Unloaded,
+	Loading,
+	Loaded,
+	Failed
+};
+
+/** Gets the name of a standard cursor type (e.g. for logs and saved data). */
+CURSORY_API const TCHAR* LexToString(EMouseCursor::Type CursorType);
+
 USTRUCT(BlueprintType)
 struct FCursorInfo 
 {
@@ -34,6 +61,13 @@ public:
 	UPROPERTY(EditAnywhere, Category = Info)
 	FVector2D Hotspot;
 
+	/**
+	 * When this cursor is loaded. Critical (the default) cursors are ready on the first frame, but delay startup;
+	 * cursors not needed right away (i.e. anything but base and menu cursors) can be made Normal or Deferred.
+	 */
+	UPROPERTY(EditAnywhere, Category = Info)
+	ECursorLoadPriority LoadPriority{ECursorLoadPriority::Critical};
+
 	/** Allows using this struct as a TSet/TMap key. */
 	bool operator==(const FCursorInfo& Other) const
 	{
@@ -57,6 +91,30 @@ struct TStructOpsTypeTraits<FCursorInfo> : public TStructOpsTypeTraitsBase2<FCur
 	};
 };
 
+/**
+ * A named set of cursor art (e.g. colorblind, large, per-faction).
+ * Maps logical cursor identifiers to theme-specific images.
+ */
+USTRUCT(BlueprintType)
+struct FCursorTheme
+{
+	GENERATED_BODY()
+
+public:
+
+	/** The name used to select this theme. */
+	UPROPERTY(EditAnywhere, Category = Theme)
+	FName Name;
+
+	/** 
+	 * Cursor specs used while this theme is active.
+	 * Identifiers should match those of the base cursor specs.
+	 * Identifiers not listed here fall back to the base cursor.
+	 */
+	UPROPERTY(EditAnywhere, Category = Theme)
+	TSet<FCursorInfo> CursorSpecs;
+};
+
 USTRUCT(BlueprintType)
 struct FCursorStackElementHandle
 {
@@ -68,6 +126,9 @@ public:
 	
 	bool IsValid() const;
 
+	/** Describes this handle, for debugging. */
+	FString ToString() const;
+
 	/** Allow this struct to be used as TSet/TMap key. */
 	bool operator==(const FCursorStackElementHandle& Other) const
 	{